@@ -0,0 +1,340 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "game.hpp"
+#include "actors/random_player.hpp"
+#include "components/board.hpp"
+#include "components/shapes.hpp"
+#include "search/fill_solver.hpp"
+#include "search/monte_carlo.hpp"
+#include "util/allocation_counter.hpp"
+
+// Measures the time and number of allocations of the hot paths of the rules
+// over a fixed set of early, mid and late game positions. The results are
+// printed as CSV or JSON so runs from different versions can be compared.
+
+// Keeps the results of the measured calls so they aren't optimized away.
+static volatile long long sink = 0;
+
+static void keep(long long value) {
+    sink = sink + value;
+}
+
+struct Options {
+    int blocks = Board::default_board_size;
+    std::string format = "csv";
+    double min_time_ms = 200.0;
+};
+
+// A position from the corpus along with the game it came from.
+struct Position {
+    std::string name;
+    std::unique_ptr<Game> game;
+    int placements;
+};
+
+struct Result {
+    std::string benchmark;
+    std::string position;
+    long long iterations;
+    double ns_per_op;
+    double allocations_per_op;
+};
+
+// Gives the benchmarks access to the private rule checks of `Game`.
+class EngineBenchmark {
+
+    public:
+        static bool check_if_space_in_board_slot(const Game& game, shape_id shape, int x, int y) {
+            return game.check_if_space_in_board_slot(shape, x, y, game.board_);
+        }
+
+        static bool check_if_connected_to_existing_pieces(const Game& game, int owner,
+            shape_id shape, int x, int y) {
+            return game.check_if_connected_to_existing_pieces(owner, shape, x, y, game.board_);
+        }
+
+        static bool fill_slot(Game& game, Board& board, int id, int x, int y) {
+            return game.fill_slot(board, id, x, y);
+        }
+};
+
+// The first version of `Game::simulate_filling_placements`, kept to compare the
+// current version against. It keeps the slots left to try in a set, which
+// allocates for every slot added, and tries every shape with the full rule check.
+static void legacy_simulate_filling_placements(const Game& game, Board& board, int id) {
+    const int size = board.get_size();
+    std::set<std::pair<int, int>> potential_positions;
+
+    auto add_neighbours = [&potential_positions, size](int i, int j) {
+        for (int h = std::max(i - 1, 0); h < std::min(i + 2, size); ++h) {
+            for (int w = std::max(j - 1, 0); w < std::min(j + 2, size); ++w) {
+                potential_positions.insert({h, w});
+            }
+        }
+    };
+
+    for (int i = 0; i < size; ++i) {
+        for (int j = 0; j < size; ++j) {
+            const Board::slot_contents slot = board.get_slot(j, i);
+
+            if ((slot.first && slot.first.owner == id) || (slot.second && slot.second.owner == id)) {
+                add_neighbours(i, j);
+            }
+        }
+    }
+
+    while (!potential_positions.empty()) {
+        const auto [i, j] = potential_positions.extract(potential_positions.begin()).value();
+
+        for (shape_id shape = 0; shape < shape_count; ++shape) {
+            if (game.check_if_valid_placement(id, shape, j, i, 0, board)) {
+                board.place_piece(id, shape, j, i);
+                add_neighbours(i, j);
+                break;
+            }
+        }
+    }
+}
+
+// Plays a random game with a fixed seed up to a number of placements, or
+// until the game is finished.
+static int play_to(Game& game, std::uint64_t seed, int placements) {
+    RandomPlayer player(seed);
+    Game::Placement placement;
+    int placed = 0;
+
+    while (placed < placements && !game.is_finished()
+        && player.choose_placement(game, placement)) {
+        game.place(placement);
+        ++placed;
+    }
+
+    return placed;
+}
+
+// Runs `op` in batches until at least the minimum time has passed and returns
+// the time and allocations per call.
+static Result measure(const std::string& benchmark, const std::string& position,
+    double min_time_ms, const std::function<void()>& op) {
+
+    // Warm up once so lazily created state isn't counted
+    op();
+
+    long long iterations = 0;
+    long long batch = 1;
+    const long long start_allocations = get_allocation_count();
+    const auto start = std::chrono::steady_clock::now();
+    double elapsed_ms = 0.0;
+
+    while (elapsed_ms < min_time_ms) {
+        for (long long i = 0; i < batch; ++i) {
+            op();
+        }
+
+        iterations += batch;
+        batch *= 2;
+        elapsed_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+
+    const long long op_allocations = get_allocation_count() - start_allocations;
+
+    return Result{benchmark, position, iterations, elapsed_ms * 1e6 / iterations,
+        double(op_allocations) / iterations};
+}
+
+static bool parse_options(int argc, char** argv, Options& options) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--size") == 0) {
+            options.blocks = std::atoi(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--format") == 0) {
+            options.format = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--min-time") == 0) {
+            options.min_time_ms = std::atof(argv[i + 1]);
+        } else {
+            return false;
+        }
+    }
+
+    return argc % 2 == 1 && options.blocks >= 2 && options.blocks <= Board::max_board_size
+        && (options.format == "csv" || options.format == "json");
+}
+
+static void print_results(const std::vector<Result>& results, const Options& options) {
+    if (options.format == "csv") {
+        std::cout << "benchmark,position,iterations,ns_per_op,allocations_per_op\n";
+
+        for (const Result& result : results) {
+            std::cout << result.benchmark << "," << result.position << "," << result.iterations
+                      << "," << result.ns_per_op << "," << result.allocations_per_op << "\n";
+        }
+    } else {
+        std::cout << "{\n  \"board_size\": " << options.blocks << ",\n  \"results\": [\n";
+
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const Result& result = results[i];
+            std::cout << "    {\"benchmark\": \"" << result.benchmark << "\", \"position\": \""
+                      << result.position << "\", \"iterations\": " << result.iterations
+                      << ", \"ns_per_op\": " << result.ns_per_op << ", \"allocations_per_op\": "
+                      << result.allocations_per_op << "}" << (i + 1 < results.size() ? "," : "")
+                      << "\n";
+        }
+
+        std::cout << "  ]\n}\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+
+    if (!parse_options(argc, argv, options)) {
+        std::cerr << "Usage: bench_engine [--size N] [--format csv|json] [--min-time MS]\n";
+        return EXIT_FAILURE;
+    }
+
+    // The corpus is the same random game stopped at different points
+    const std::uint64_t seed = 475;
+    const int area = options.blocks * options.blocks;
+    const int stops[] = {area / 8, area / 2, area * 2};
+    const char* names[] = {"early", "mid", "late"};
+
+    std::vector<Position> corpus;
+
+    for (int i = 0; i < 3; ++i) {
+        auto game = std::make_unique<Game>(options.blocks, 2, nullptr);
+        const int placements = play_to(*game, seed, stops[i]);
+        corpus.push_back(Position{names[i], std::move(game), placements});
+    }
+
+    std::vector<Result> results;
+
+    for (Position& position : corpus) {
+        Game& game = *position.game;
+        const Board& board = game.get_board();
+        const int size = board.get_size();
+        const int id = game.get_current_actor();
+        const int half_squares_placed = game.get_half_squares_placed();
+
+        // Every slot and shape is checked in turn
+        int next_query = 0;
+        auto next = [&next_query, size](int& x, int& y, shape_id& shape) {
+            const int query = next_query;
+            next_query = (next_query + 1) % (size * size * shape_count);
+            shape = query % shape_count;
+            x = (query / shape_count) % size;
+            y = query / shape_count / size;
+        };
+
+        results.push_back(measure("check_if_valid_placement", position.name,
+            options.min_time_ms, [&] {
+            int x, y;
+            shape_id shape;
+            next(x, y, shape);
+            keep(game.check_if_valid_placement(id, shape, x, y, half_squares_placed, board));
+        }));
+
+        results.push_back(measure("check_if_space_in_board_slot", position.name,
+            options.min_time_ms, [&] {
+            int x, y;
+            shape_id shape;
+            next(x, y, shape);
+            keep(EngineBenchmark::check_if_space_in_board_slot(game, shape, x, y));
+        }));
+
+        results.push_back(measure("check_if_connected_to_existing_pieces", position.name,
+            options.min_time_ms, [&] {
+            int x, y;
+            shape_id shape;
+            next(x, y, shape);
+            keep(EngineBenchmark::check_if_connected_to_existing_pieces(game, id, shape, x, y));
+        }));
+
+        // Filling changes the board, so it's reset after trying every slot once
+        Board filled = board;
+        int next_slot = 0;
+        std::vector<Game::Placement> placements(Game::get_max_placements(size));
+
+        results.push_back(measure("generate_placements", position.name,
+            options.min_time_ms, [&] {
+            keep(game.generate_placements(id, half_squares_placed, board, placements));
+        }));
+
+        results.push_back(measure("count_placements", position.name,
+            options.min_time_ms, [&] {
+            keep(game.count_placements(id, half_squares_placed, board));
+        }));
+
+        results.push_back(measure("fill_slot", position.name, options.min_time_ms, [&] {
+            if (next_slot == size * size) {
+                filled = board;
+                next_slot = 0;
+            }
+
+            keep(EngineBenchmark::fill_slot(game, filled, id, next_slot % size,
+                next_slot / size));
+            ++next_slot;
+        }));
+
+        // Includes copying the board to simulate on
+        results.push_back(measure("simulate_filling_placements", position.name,
+            options.min_time_ms, [&] {
+            filled = board;
+            game.simulate_filling_placements(filled, id);
+        }));
+
+        results.push_back(measure("simulate_filling_placements_legacy", position.name,
+            options.min_time_ms, [&] {
+            filled = board;
+            legacy_simulate_filling_placements(game, filled, id);
+        }));
+
+        FillSolver solver(1);
+        results.push_back(measure("fill_solver", position.name, options.min_time_ms, [&] {
+            filled = board;
+            keep(solver.solve(filled, id));
+        }));
+
+        Board final_board(size, 2);
+        results.push_back(measure("check_if_game_is_finished", position.name,
+            options.min_time_ms, [&] {
+            final_board.clear();
+            keep(game.check_if_game_is_finished(final_board));
+        }));
+
+        // A search of a single playout on one thread, which is mostly the playout
+        MonteCarloSearch::Limits playout_limits;
+        playout_limits.time = std::chrono::milliseconds(0);
+        playout_limits.playouts = 1;
+        playout_limits.max_nodes = 1 << 16;
+        MonteCarloSearch playout_search(playout_limits);
+
+        results.push_back(measure("monte_carlo_playout", position.name,
+            options.min_time_ms, [&] {
+            keep(playout_search.search(board, 2, id, half_squares_placed).count);
+        }));
+
+        results.push_back(measure("board_copy", position.name, options.min_time_ms, [&] {
+            Board copy = board;
+            keep(copy.get_size());
+        }));
+
+        results.push_back(measure("board_assign", position.name, options.min_time_ms, [&] {
+            filled = board;
+            keep(filled.get_size());
+        }));
+    }
+
+    print_results(results, options);
+
+    return EXIT_SUCCESS;
+}
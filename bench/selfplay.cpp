@@ -0,0 +1,174 @@
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "game.hpp"
+#include "actors/random_player.hpp"
+#include "components/board.hpp"
+
+// Plays complete games between random players with fixed seeds to measure how
+// fast the rules run. Every game is also reduced to a digest of its placements
+// and final scores, so changes to the rules can be checked for giving the same
+// games as before. A single seed can be replayed to see each of its placements.
+
+struct Options {
+    int blocks = Board::default_board_size;
+    int games = 100;
+    std::uint64_t seed = 0;
+    int threads = 1;
+    bool replay = false;
+};
+
+// Timings of a set of games in nanoseconds.
+struct Timings {
+    std::vector<double> moves;
+    std::vector<double> checks;
+};
+
+using clock_type = std::chrono::steady_clock;
+
+static double elapsed_ns(clock_type::time_point start) {
+    return std::chrono::duration<double, std::nano>(clock_type::now() - start).count();
+}
+
+// Mixes a value into a digest using FNV-1a.
+static void mix(std::uint64_t& digest, std::uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        digest ^= (value >> (8 * i)) & 0xFF;
+        digest *= 1099511628211ull;
+    }
+}
+
+// Plays one game until the end of game check finds it finished. Returns the
+// number of placements and adds the game to the digest.
+static int play_game(const Options& options, std::uint64_t seed, Timings& timings,
+    std::uint64_t& digest) {
+    Game game(options.blocks, 2, nullptr);
+    game.set_simulation_threads(options.threads);
+
+    RandomPlayer player(seed);
+    Game::Placement placement;
+    Board final_board(options.blocks, 2);
+    int placements = 0;
+
+    while (true) {
+        // Check if the game is finished, as the game loop does after each placement
+        clock_type::time_point start = clock_type::now();
+        final_board.clear();
+        const bool finished = game.check_if_game_is_finished(final_board);
+        timings.checks.push_back(elapsed_ns(start));
+
+        if (finished) {
+            break;
+        }
+
+        // Pick and make a move
+        start = clock_type::now();
+        const int actor = game.get_current_actor();
+
+        if (!player.choose_placement(game, placement)) {
+            break;
+        }
+
+        game.place(placement);
+        timings.moves.push_back(elapsed_ns(start));
+
+        ++placements;
+        mix(digest, (std::uint64_t(placement.y) << 32) | (placement.x << 8) | placement.shape);
+
+        if (options.replay) {
+            std::cout << "Player " << actor << ": " << placement.x << " " << placement.y
+                      << " " << int(placement.shape) << "\n";
+        }
+    }
+
+    for (int id = 0; id < 2; ++id) {
+        mix(digest, std::uint64_t(final_board.get_score(id) * 2));
+    }
+
+    if (options.replay) {
+        std::cout << "Scores: " << final_board.get_score(0) << " " << final_board.get_score(1)
+                  << "\n";
+    }
+
+    return placements;
+}
+
+// Gets a percentile of a set of samples.
+static double percentile(std::vector<double>& samples, double fraction) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+
+    auto nth = samples.begin() + std::size_t(fraction * (samples.size() - 1));
+    std::nth_element(samples.begin(), nth, samples.end());
+
+    return *nth;
+}
+
+static bool parse_options(int argc, char** argv, Options& options) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--size") == 0) {
+            options.blocks = std::atoi(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--games") == 0) {
+            options.games = std::atoi(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--seed") == 0) {
+            options.seed = std::strtoull(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--threads") == 0) {
+            options.threads = std::atoi(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--replay") == 0) {
+            options.seed = std::strtoull(argv[i + 1], nullptr, 10);
+            options.games = 1;
+            options.replay = true;
+        } else {
+            return false;
+        }
+    }
+
+    return argc % 2 == 1 && options.blocks >= 2 && options.blocks <= Board::max_board_size
+        && options.games > 0;
+}
+
+int main(int argc, char** argv) {
+    Options options;
+
+    if (!parse_options(argc, argv, options)) {
+        std::cerr << "Usage: bench_selfplay [--size N] [--games N] [--seed N] [--threads N]\n"
+                  << "       bench_selfplay [--size N] --replay SEED\n";
+        return EXIT_FAILURE;
+    }
+
+    Timings timings;
+    std::uint64_t digest = 14695981039346656037ull;
+    long long placements = 0;
+
+    const clock_type::time_point start = clock_type::now();
+
+    for (int i = 0; i < options.games; ++i) {
+        placements += play_game(options, options.seed + i, timings, digest);
+    }
+
+    const double seconds = elapsed_ns(start) / 1e9;
+
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    std::cout << "games: " << options.games << "\n"
+              << "placements: " << placements << "\n"
+              << "games_per_second: " << options.games / seconds << "\n"
+              << "moves_per_second: " << placements / seconds << "\n"
+              << "move_p50_ns: " << percentile(timings.moves, 0.50) << "\n"
+              << "move_p99_ns: " << percentile(timings.moves, 0.99) << "\n"
+              << "end_check_p50_ns: " << percentile(timings.checks, 0.50) << "\n"
+              << "end_check_p99_ns: " << percentile(timings.checks, 0.99) << "\n"
+              << "peak_rss_kb: " << usage.ru_maxrss << "\n"
+              << "digest: " << std::hex << digest << std::dec << "\n";
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,27 @@
+#ifndef actor_hpp
+#define actor_hpp
+
+#include "components/piece.hpp"
+#include "input/actions.hpp"
+
+class Game;
+
+// Something that takes turns in a game, such as a person at the mouse or the
+// computer.
+class Actor {
+
+    public:
+        virtual ~Actor() = default;
+
+        // Returns the next action to take on the actor's turn in a game.
+        virtual Action do_action(const Game& game) = 0;
+
+        // Gets the slot and shape the actor is pointing the cursor at, for actors
+        // that choose their own placements. Returns false if the cursor should
+        // follow the mouse instead.
+        virtual bool get_cursor(int&, int&, shape_id&) const {
+            return false;
+        }
+};
+
+#endif
@@ -3,11 +3,12 @@
 
 #include <memory>
 
+#include "actors/actor.hpp"
 #include "input/input_handler.hpp"
 #include "input/actions.hpp"
 
-// A class for representing the players of the game.
-class Player {
+// A class for representing the people playing the game with the mouse.
+class Player : public Actor {
 
     public: 
 
@@ -17,7 +18,7 @@ class Player {
         ~Player();
 
         // Returns an action based on the input from the input handler.
-        Action do_action();
+        Action do_action(const Game& game) override;
 
         // Sets the player's input handler
         void set_input_handler(InputHandler* input_handler);
@@ -0,0 +1,29 @@
+#ifndef random_player_hpp
+#define random_player_hpp
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "game.hpp"
+
+// A player that picks a random valid placement on its turn. The same seed
+// always picks the same placements, so random games can be played again.
+class RandomPlayer {
+
+    public:
+        // Creates a random player with a seed for its random number generator.
+        RandomPlayer(std::uint64_t seed);
+
+        // Picks a random valid placement for the actor whose turn it is.
+        // Returns false if there is no valid placement.
+        bool choose_placement(const Game& game, Game::Placement& placement);
+
+    private:
+        std::mt19937_64 generator_;
+
+        // Reused between turns as the buffer to generate valid placements into.
+        std::vector<Game::Placement> placements_;
+};
+
+#endif
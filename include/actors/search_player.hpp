@@ -0,0 +1,122 @@
+#ifndef search_player_hpp
+#define search_player_hpp
+
+#include <chrono>
+#include <future>
+#include <memory>
+
+#include "actors/actor.hpp"
+#include "components/shapes.hpp"
+#include "game.hpp"
+#include "record/opening_book.hpp"
+#include "search/alpha_beta.hpp"
+#include "search/monte_carlo.hpp"
+
+// A computer player that searches for its turns with a `Search`, such as
+// `AlphaBetaSearch`. The search runs on another thread, so the game keeps
+// running while it thinks, and the placements are made by pointing the cursor
+// at them. Positions that are in an opening book are played from the book
+// straight away instead.
+template <typename Search>
+class SearchPlayer : public Actor {
+
+    public:
+        SearchPlayer(const typename Search::Limits& limits)
+            : search_(limits), placed_(0), cursor_{0, 0, triangle_shape} {}
+
+        ~SearchPlayer() {
+            // Don't wait for the whole search if it's still running
+            search_.cancel();
+
+            if (pending_search_.valid()) {
+                pending_search_.wait();
+            }
+        }
+
+        // Starts searching on the actor's turn and places the turn it finds once
+        // the search is done. Returns no action while searching.
+        Action do_action(const Game& game) override {
+
+            // Wait for the search to finish before placing anything
+            if (pending_search_.valid()) {
+                if (pending_search_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                    return Action::NONE;
+                }
+
+                turn_ = pending_search_.get();
+                placed_ = 0;
+            }
+
+            const int id = game.get_current_actor();
+            const int half_squares_placed = game.get_half_squares_placed();
+
+            // The book has a placement for each position, including after a half,
+            // so anything found before is replaced
+            Game::Placement book_placement;
+
+            if (opening_book_ && opening_book_->find(game.get_board(), id, half_squares_placed,
+                book_placement) && game.check_if_valid_placement(id, book_placement.shape,
+                book_placement.x, book_placement.y, half_squares_placed, game.get_board())) {
+                turn_ = typename Search::Turn{};
+                placed_ = 0;
+                cursor_ = book_placement;
+                return Action::PLACE;
+            }
+
+            // Place the rest of the turn that was found
+            if (placed_ < turn_.count) {
+                const Game::Placement& placement = turn_.placements[placed_];
+
+                if (game.check_if_valid_placement(id, placement.shape, placement.x, placement.y,
+                    half_squares_placed, game.get_board())) {
+                    cursor_ = placement;
+                    ++placed_;
+                    return Action::PLACE;
+                }
+            }
+
+            // Search for a new turn on a copy of the board, since the game can't be
+            // used from the search's thread.
+            turn_ = typename Search::Turn{};
+            placed_ = 0;
+
+            pending_search_ = std::async(std::launch::async,
+                [this, board = game.get_board(), num_actors = game.get_num_actors(), id,
+                    half_squares_placed] {
+                    return search_.search(board, num_actors, id, half_squares_placed);
+                });
+
+            return Action::NONE;
+        }
+
+        // Plays the positions in a book without searching them. The book can be
+        // shared between players, and a null book stops using one.
+        void set_opening_book(std::shared_ptr<const OpeningBook> opening_book) {
+            opening_book_ = std::move(opening_book);
+        }
+
+        bool get_cursor(int& x, int& y, shape_id& shape) const override {
+            x = cursor_.x;
+            y = cursor_.y;
+            shape = cursor_.shape;
+            return true;
+        }
+
+    private:
+        Search search_;
+        std::shared_ptr<const OpeningBook> opening_book_;
+
+        // The search that is running, if any.
+        std::future<typename Search::Turn> pending_search_;
+
+        // The turn that was found and how many of its placements are made.
+        typename Search::Turn turn_;
+        int placed_;
+
+        Game::Placement cursor_;
+};
+
+using AlphaBetaPlayer = SearchPlayer<AlphaBetaSearch>;
+using MonteCarloPlayer = SearchPlayer<MonteCarloSearch>;
+
+#endif
@@ -1,46 +1,235 @@
 #ifndef board_hpp
 #define board_hpp
 
-#include <array>
+#include <cstdint>
 #include <memory>
 #include <utility>
+#include <vector>
 #include <components/piece.hpp>
+#include <components/shapes.hpp>
+#include <util/hash.hpp>
 
 class Board {
 
-    public: 
+    public:
 
-        // The size of the board
-        static constexpr int board_size = 8;
+        // The size of the board when no size is given
+        static constexpr int default_board_size = 8;
 
-        using board_slot = typename std::pair<std::shared_ptr<Piece>,
-                                              std::shared_ptr<Piece>>;
+        // The largest size of board that is supported
+        static constexpr int max_board_size = 1024;
 
-        // Store the board as a 2d Array of Piece pointers 
-        // Need pointers to take advantage of abstract class
-        using board_type = std::array<std::array<board_slot, board_size>, board_size>;
+        // The number of players that the board has bit planes for when not given.
+        static constexpr int default_players = 2;
 
-        using board_pointer = const std::array<board_slot, board_size>*;
+        // The number of players that get an initial square. Any other player
+        // could never place a piece, so no more than this can play a game.
+        static constexpr int initial_square_players = 2;
 
-        Board();
+        // A word of a bit plane, which has one bit for every slot of the board
+        // with the slot at x and y stored at bit y * size + x.
+        using bitboard = std::uint64_t;
+
+        using board_slot = typename std::pair<std::shared_ptr<const Piece>,
+                                              std::shared_ptr<const Piece>>;
+
+        // A piece stored in a slot as an owner and a shape. An empty
+        // half of a slot has a negative owner.
+        struct slot_piece {
+            int owner = -1;
+            shape_id shape = square_shape;
+
+            explicit operator bool() const {
+                return owner >= 0;
+            }
+
+            friend bool operator==(const slot_piece&, const slot_piece&) = default;
+        };
+
+        // The pieces in a slot in the order they were placed.
+        struct slot_contents {
+            slot_piece first;
+            slot_piece second;
+        };
+
+        // Read only view of the board that creates the pieces of a slot when
+        // it's indexed. This keeps code that works with `Piece` objects working
+        // while the board itself only stores bits.
+        class board_view {
+
+            public:
+                class row_view {
+
+                    public:
+                        row_view(const Board* board, int y) : board_(board), y_(y) {}
+
+                        board_slot operator[](int x) const;
+
+                    private:
+                        const Board* board_;
+                        int y_;
+                };
+
+                board_view(const Board* board) : board_(board) {}
+
+                row_view operator[](int y) const {
+                    return row_view(board_, y);
+                }
+
+            private:
+                const Board* board_;
+        };
+
+        using board_pointer = board_view;
+
+        // Creates a square board with `size` slots on each side that has pieces
+        // for up to `players` players.
+        // Precondition: size is in range [2,1024] and players is at least 2
+        Board(int size = default_board_size, int players = default_players);
 
         const board_pointer get_board() const;
 
+        // Gets the number of slots on each side of the board.
+        int get_size() const;
+
+        // Gets the number of players the board has pieces for.
+        int get_players() const;
+
+        // Gets the pieces in the slot at a given x and y.
+        // Precondition: x and y are in range [0,size)
+        slot_contents get_slot(int x, int y) const;
+
+        // Gets which of the nine points of the slot at x and y are points of one of
+        // `owner`'s pieces, in the same order as `ShapeInfo::point_mask`.
+        // Precondition: x and y are in range [0,size)
+        std::uint16_t get_touching_points(int owner, int x, int y) const;
+
+        // Checks if any point of a shape placed at x and y is also a point of one of
+        // `owner`'s pieces.
+        // Precondition: x and y are in range [0,size)
+        bool check_if_touching_owner(int owner, shape_id shape, int x, int y) const;
+
         // Attempts to place a given piece at a given x and y on the board
-        // Precondition: x and y are in range [0,7]
+        // Precondition: x and y are in range [0,size)
+        // If successful returns true, otherwise false
+        bool place_piece(std::shared_ptr<const Piece> piece, int x, int y);
+
+        // Attempts to place a piece with a given owner and shape at a given x and y.
+        // A slot can hold a square or two halves that are rotated 180 degrees from
+        // each other.
+        // Precondition: x and y are in range [0,size)
         // If successful returns true, otherwise false
-        bool place_piece(std::shared_ptr<Piece> piece, int x, int y);
+        bool place_piece(int owner, shape_id shape, int x, int y);
+
+        // Removes the piece with a given owner and shape from the slot at x and y,
+        // leaving the board as if the piece had never been placed. Points the
+        // piece shares with the owner's other pieces stay points of the owner.
+        // Precondition: x and y are in range [0,size)
+        // Returns false if the slot has no such piece.
+        bool remove_piece(int owner, shape_id shape, int x, int y);
+
+        // Removes the piece that was placed last like above, given the touching
+        // points of the owner at x and y from just before it was placed, so only
+        // the points the piece added are taken away without looking around it.
+        // Precondition: x and y are in range [0,size) and nothing placed since
+        // the piece is still on the board
+        // Returns false if the slot has no such piece.
+        bool remove_piece(int owner, shape_id shape, int x, int y, std::uint16_t touching_before);
 
         // Clears the board of all pieces and reverts it to the initial state.
         void clear();
 
+        // Gets the Zobrist key of the pieces on the board, which is kept up to date
+        // as pieces are placed. Boards with the same pieces have the same key no
+        // matter what order they were placed in.
+        std::uint64_t get_key() const;
+
+        // Gets a count that goes up whenever the board changes, so anything made
+        // from the board can tell if it's out of date. Copies of a board have the
+        // same generation as it.
+        std::uint64_t get_generation() const;
+
+        // Computes the key of the board from its pieces instead of keeping it
+        // up to date.
+        std::uint64_t compute_key() const;
+
+        // Gets the key of a piece with a given owner and shape in the slot at x and y.
+        // The shape says which half of the slot the piece is in. Keys are computed
+        // when needed, so no table of keys is needed for large boards.
+        static std::uint64_t get_piece_key(int owner, shape_id shape, int x, int y) {
+            const std::uint64_t slot = static_cast<std::uint64_t>(y) * max_board_size + x;
+            return mix_bits((slot * 256 + owner) * shape_count + shape);
+        }
+
         float get_score(int id) const;
-       
+
     private:
-        board_type board_;
+        int size_;
+        int players_;
+
+        // The number of words needed for a bit plane of the slots.
+        int plane_words_;
+
+        // The width of the lattice of points that pieces can have. It has the
+        // corners of the slots, the middle of their sides and their centers.
+        int lattice_size_;
+
+        // The number of words needed for each player's lattice.
+        int lattice_words_;
+
+        // Bit planes of the slots each player has a piece of each shape in.
+        // The planes are stored word by word, so the words for the same slots
+        // of every player and shape are next to each other.
+        std::vector<bitboard> planes_;
+
+        // Slots where the half with the larger shape id was placed first.
+        std::vector<bitboard> partner_placed_first_;
+
+        // The points of each player's pieces, one lattice after another. A point
+        // at column `c` and row `r` from the top left is stored at bit
+        // r * lattice_size_ + c of its owner's lattice. These are updated as pieces
+        // are placed so checking if a piece is connected only has to look at its
+        // own points.
+        std::vector<std::uint64_t> lattices_;
+
+        // The xor of the keys of every piece on the board.
+        std::uint64_t key_;
+
+        // How many times the board has changed.
+        std::uint64_t generation_;
 
         void place_initial_squares();
 
+        // Gets the bit of the bit planes for the slot at x and y.
+        int get_slot_index(int x, int y) const {
+            return y * size_ + x;
+        }
+
+        // Gets the word of the bit planes for a word of slots, owner and shape.
+        int get_plane_index(int word, int owner, shape_id shape) const {
+            return (word * players_ + owner) * shape_count + shape;
+        }
+
+        // Gets the bit of the lattice for a point of a shape placed at x and y.
+        int get_lattice_index(Piece::Point point, int x, int y) const {
+            // Points have y going up, while rows of the lattice go down.
+            return (2 * y + 1 - point.y) * lattice_size_ + 2 * x + 1 + point.x;
+        }
+
+        // Adds the points of a shape placed at x and y to the owner's lattice.
+        void add_to_lattice(int owner, shape_id shape, int x, int y);
+
+        // Removes the points of a shape that was at x and y from the owner's
+        // lattice, apart from those that are still points of another of their pieces.
+        void remove_from_lattice(int owner, shape_id shape, int x, int y);
+
+        // Takes a piece's bits out of the bit planes and its key out of the key,
+        // leaving the lattice to the caller. Returns false if there's no such piece.
+        bool remove_from_planes(int owner, shape_id shape, int x, int y);
+
+        // Checks if the point at a column and row of the lattice is a point of
+        // any of the owner's pieces in the slots around it.
+        bool check_if_point_of_owner(int owner, int column, int row) const;
 };
 
 #endif
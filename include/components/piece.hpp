@@ -3,14 +3,18 @@
 
 #include <vector>
 #include <memory>
+#include <cstdint>
 #include <algorithm>
 #include <iostream>
 
+// Identifies one of the shapes a piece can take in a board slot.
+// See `shapes.hpp` for the catalogue of shapes.
+using shape_id = std::uint8_t;
 
 class Piece {
 
-    public: 
-        
+    public:
+
         // Type to represent 2d Point
         struct Point {
             int x;
@@ -20,7 +24,7 @@ class Piece {
             Point& operator+=(const Point& rhs) {
                 x += rhs.x;
                 y += rhs.y;
-                return *this; 
+                return *this;
             }
         };
 
@@ -35,7 +39,7 @@ class Piece {
             counterclockwise
         };
 
-        Piece(int owner_id);
+        Piece(int owner_id, shape_id shape);
 
         virtual ~Piece() {};
 
@@ -43,51 +47,30 @@ class Piece {
 
         piece_type get_piece_type() const;
 
+        // Returns the id of the piece's current shape.
+        shape_id get_shape() const;
+
         int get_owner_id() const;
 
-        // Rotates the piece either clockwise or counterclockwise, with 
+        // Rotates the piece either clockwise or counterclockwise, with
         // clockwise being default.
         void rotate(rotation rot = Piece::rotation::clockwise);
 
         virtual std::shared_ptr<Piece> clone() const = 0;
 
-    protected: 
-        std::vector<Point> points_;
-        int rotation_; // Stores rotation in degrees
-        piece_type piece_type_;
-        int owner_id_; 
+    protected:
+        shape_id shape_;
+        int owner_id_;
 };
 
+// Two pieces are the same if they have the same shape. Squares stay the same
+// when rotated, so all squares share a single shape.
 inline bool operator==(const Piece& lhs, const Piece& rhs) {
-  
-    // Check for matching type
-    if (lhs.get_piece_type() != rhs.get_piece_type()) {
-        return false;
-    }
 
-    // Note: checking for the same ownership doesn't work since when we 
+    // Note: checking for the same ownership doesn't work since when we
     // compare pieces to see if they fit in the same slot as each other
     // we need to ignore the ownership.
-
-    // Check for matching points.
-    std::vector<Piece::Point> lhs_points = lhs.get_points();
-    std::vector<Piece::Point> rhs_points = rhs.get_points();
-
-    // Pieces with points in different orders are still the same piece.
-    std::sort(lhs_points.begin(), lhs_points.end());
-    std::sort(rhs_points.begin(), rhs_points.end());
-
-    if (lhs_points.size() != rhs_points.size()) {
-        return false;
-    }
-
-    for (int i = 0; i < lhs_points.size(); ++i) {
-        if (lhs_points[i] != rhs_points[i]) {
-            return false;
-        }
-    }
-
-    return true;
+    return lhs.get_shape() == rhs.get_shape();
 }
 
 #endif
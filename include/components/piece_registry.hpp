@@ -0,0 +1,21 @@
+#ifndef piece_registry_hpp
+#define piece_registry_hpp
+
+#include <memory>
+
+#include "piece.hpp"
+
+// Hands out the pieces used for drawing and the cursor. There is only one piece
+// for each owner and shape, which is shared by everything that asks for it, so
+// pieces are never made again once an owner's pieces exist. Pieces can't be
+// changed, so a rotated piece is a different piece that is asked for instead.
+class PieceRegistry {
+
+    public:
+        // Gets the piece with a given owner and shape. All of an owner's pieces are
+        // made the first time any of them is asked for.
+        // Precondition: owner is at least 0
+        static std::shared_ptr<const Piece> get_piece(int owner, shape_id shape);
+};
+
+#endif
@@ -11,6 +11,10 @@ class Rectangle: public Piece {
         // in the upper half of a square.
         Rectangle(int owner_id);
 
+        // Creates a rectangle with a specific owner that has already been
+        // rotated into the given rectangle shape.
+        Rectangle(int owner_id, shape_id shape);
+
         ~Rectangle();
     
         // Returns a shared pointer to a clone of the triangle.
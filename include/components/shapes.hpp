@@ -0,0 +1,116 @@
+#ifndef shapes_hpp
+#define shapes_hpp
+
+#include <array>
+#include <cstdint>
+
+#include "piece.hpp"
+
+// The number of distinct shapes a piece can take in a slot: a square,
+// four triangle rotations and four rectangle rotations.
+inline constexpr int shape_count = 9;
+
+// Shape ids of the first rotation of each type of piece. Each clockwise
+// rotation of a half piece adds one to its shape id.
+inline constexpr shape_id square_shape = 0;
+inline constexpr shape_id triangle_shape = 1;
+inline constexpr shape_id rectangle_shape = 5;
+
+// A slot is split into eight regions by its diagonals and the lines through
+// the middle of its sides. Region 0 is to the right of the top left corner
+// and the rest follow clockwise, so rotating clockwise by 90 degrees moves
+// each region forward by two.
+inline constexpr int region_count = 8;
+
+// Everything that is known about a shape ahead of time.
+struct ShapeInfo {
+    Piece::piece_type type;
+
+    // Clockwise rotation of the shape in degrees.
+    int rotation;
+
+    // The corners of the shape in the same order as `Piece::get_points()`.
+    int point_count;
+    std::array<Piece::Point, 4> points;
+
+    // The regions of a slot that the shape covers.
+    std::uint8_t regions;
+
+    // The points of the shape out of the nine points of a slot. The point at
+    // (x,y) is bit (1 - y) * 3 + x + 1, so the bits go across each row from
+    // the top left.
+    std::uint16_t point_mask;
+
+    // The shape rotated by 180 degrees, which is the only shape that can
+    // share a slot with it.
+    shape_id partner;
+
+    // The shape rotated by 90 degrees in each direction.
+    shape_id clockwise;
+    shape_id counterclockwise;
+};
+
+// Builds the catalogue by rotating the first rotation of each type of piece.
+constexpr std::array<ShapeInfo, shape_count> make_shape_catalogue() {
+    std::array<ShapeInfo, shape_count> catalogue{};
+
+    // The origin (0,0) is the center of a square and the points are the
+    // same as those of a newly constructed piece.
+    catalogue[square_shape] = ShapeInfo{Piece::piece_type::square, 0, 4,
+        {Piece::Point{-1, -1}, Piece::Point{-1, 1}, Piece::Point{1, 1}, Piece::Point{1, -1}},
+        0xFF, 0, square_shape, square_shape, square_shape};
+
+    const ShapeInfo first_halves[] = {
+        ShapeInfo{Piece::piece_type::triangle, 0, 3,
+            {Piece::Point{-1, -1}, Piece::Point{-1, 1}, Piece::Point{1, 1}, Piece::Point{}},
+            0xC3, 0, 0, 0, 0},
+        ShapeInfo{Piece::piece_type::rectangle, 0, 4,
+            {Piece::Point{-1, 0}, Piece::Point{-1, 1}, Piece::Point{1, 1}, Piece::Point{1, 0}},
+            0x87, 0, 0, 0, 0}
+    };
+    const shape_id first_ids[] = {triangle_shape, rectangle_shape};
+
+    for (int type = 0; type < 2; ++type) {
+        ShapeInfo shape = first_halves[type];
+        const shape_id first = first_ids[type];
+
+        for (int rotations = 0; rotations < 4; ++rotations) {
+            shape.rotation = rotations * 90;
+            shape.partner = first + (rotations + 2) % 4;
+            shape.clockwise = first + (rotations + 1) % 4;
+            shape.counterclockwise = first + (rotations + 3) % 4;
+            catalogue[first + rotations] = shape;
+
+            // For clockwise, replace (x,y) with (y,-x).
+            for (Piece::Point& point : shape.points) {
+                point = Piece::Point{point.y, -point.x};
+            }
+
+            shape.regions = static_cast<std::uint8_t>((shape.regions << 2) | (shape.regions >> 6));
+        }
+    }
+
+    for (ShapeInfo& shape : catalogue) {
+        for (int i = 0; i < shape.point_count; ++i) {
+            const Piece::Point point = shape.points[i];
+            shape.point_mask |= 1 << ((1 - point.y) * 3 + point.x + 1);
+        }
+    }
+
+    return catalogue;
+}
+
+inline constexpr std::array<ShapeInfo, shape_count> shape_catalogue = make_shape_catalogue();
+
+// Gets the catalogue entry of a shape.
+constexpr const ShapeInfo& get_shape_info(shape_id shape) {
+    return shape_catalogue[shape];
+}
+
+// Two halves fit in the same slot only if they cover none of the same regions.
+static_assert((get_shape_info(triangle_shape).regions
+    & get_shape_info(get_shape_info(triangle_shape).partner).regions) == 0);
+static_assert((get_shape_info(rectangle_shape).regions
+    | get_shape_info(get_shape_info(rectangle_shape).partner).regions) == 0xFF);
+
+#endif
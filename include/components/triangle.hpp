@@ -11,6 +11,10 @@ class Triangle: public Piece {
         // with the 90 degree vertex in the upper left corner.
         Triangle(int owner_id);
 
+        // Creates a triangle with a specific owner that has already been
+        // rotated into the given triangle shape.
+        Triangle(int owner_id, shape_id shape);
+
         ~Triangle();
     
         // Returns a shared pointer to a clone of the triangle.
@@ -3,12 +3,20 @@
 
 #include <vector>
 #include <memory>
+#include <span>
 
 #include "components/piece.hpp"
 #include "components/board.hpp"
+#include "components/shapes.hpp"
 #include "input/input_handler.hpp"
 #include "input/actions.hpp"
+#include "actors/actor.hpp"
 #include "actors/player.hpp"
+#include "search/reachable_region.hpp"
+#include "util/thread_pool.hpp"
+
+class GameRecordWriter;
+class FillSolver;
 
 // Runs the game by having players take turns and checks when the game is over.
 class Game {
@@ -18,31 +26,163 @@ class Game {
         struct Cursor {
             int x;
             int y;
-            std::shared_ptr<Piece> piece;
+            std::shared_ptr<const Piece> piece;
             int player_id;
         };
 
+        // Describes placing a shape in the slot at x and y.
+        struct Placement {
+            int x;
+            int y;
+            shape_id shape;
+        };
+
+        // How the end of game check fills the board for each actor to find out
+        // what they could still place. A greedy fill places a piece in every
+        // slot it can reach, while a maximum fill searches for the fill that
+        // places the most and proves that nothing places more. A greedy fill
+        // fills every slot it reaches in full, so both give the same scores.
+        enum class scoring_mode {
+            greedy_fill,
+            maximum_fill
+        };
+
+        // Creates a game on a board with `blocks` slots on each side where every
+        // actor is a player using the input handler. The input handler can be null
+        // if `progress_turn` is never called or every actor is replaced with one
+        // that doesn't use the mouse.
+        // Precondition: blocks is in range [2,1024]
         Game(int blocks, int num_players, InputHandler* input_handler);
 
-        // Switches turns between the players.
-        void progress_turn();
+        ~Game();
+
+        // Switches turns between the players. Applies at most one action of the
+        // current actor without waiting and returns it.
+        Action progress_turn();
+
+        // Replaces the actor with a given id, such as with a computer player.
+        // Precondition: id is in range [0,num_actors)
+        void set_actor(int id, std::unique_ptr<Actor> actor);
+
+        // Places a shape for the actor whose turn it is, if the placement is valid,
+        // and moves on to the next actor once their turn is used up.
+        // Returns true if the shape was placed.
+        bool place(const Placement& placement);
+
+        // Places a shape for the actor whose turn it is like `place`, but remembers
+        // what it changed so it can be undone. The move isn't recorded and the
+        // cursor stays where it is, so positions can be explored and reverted in
+        // place. Placing with `place` forgets the moves that could be undone.
+        // Returns true if the shape was placed.
+        bool make_move(const Placement& placement);
+
+        // Undoes the last move made with `make_move` that hasn't been undone,
+        // including whose turn it was and how much of it they had used.
+        // Precondition: get_move_count() > 0
+        void unmake_move();
 
-        Board get_board() const;
+        // Gets the number of moves that can be undone.
+        int get_move_count() const;
+
+        const Board& get_board() const;
+
+        // Gets the id of the actor whose turn it is.
+        int get_current_actor() const;
+
+        // Gets the number of half squares the current actor has placed this turn.
+        int get_half_squares_placed() const;
+
+        // Gets the number of actors playing.
+        int get_num_actors() const;
+
+        // Gets the number of slots on each side of the board.
+        int get_board_size() const;
+
+        // Gets the key of the position, which is the key of the board along with
+        // whose turn it is and how much of their turn they've used.
+        std::uint64_t get_key() const;
+
+        // Gets the part of a position's key for whose turn it is and how many
+        // half squares they've placed.
+        static std::uint64_t get_turn_key(int actor, int half_squares_placed);
 
         Cursor get_cursor() const;
         
         // Checks if placing a given piece is valid for the current game state.
-        bool check_if_valid_placement(std::shared_ptr<Piece> piece, int x, int y, 
+        bool check_if_valid_placement(std::shared_ptr<const Piece> piece, int x, int y, 
+            int half_squares_placed, const Board& target_board) const;
+
+        // Checks if placing a piece with a given owner and shape is valid for the
+        // current game state.
+        bool check_if_valid_placement(int owner, shape_id shape, int x, int y,
             int half_squares_placed, const Board& target_board) const;
 
+        // The most valid placements an actor can have on a board with `blocks`
+        // slots on each side, so a buffer this big always fits every placement.
+        static int get_max_placements(int blocks);
+
+        // Writes every valid placement for an owner into `placements` in order of
+        // y, then x, then shape id, without allocating. Stops once `placements` is full.
+        // Returns the number of placements written.
+        static int generate_placements(int owner, int half_squares_placed, const Board& target_board,
+            std::span<Placement> placements);
+
+        // Writes every valid placement for an owner into `placements` like above,
+        // growing it if it's too small. It never shrinks, so reusing the same
+        // vector only allocates until it's big enough.
+        static int generate_placements(int owner, int half_squares_placed, const Board& target_board,
+            std::vector<Placement>& placements);
+
+        // Counts the valid placements for an owner without storing them.
+        static int count_placements(int owner, int half_squares_placed, const Board& target_board);
+
         // Check if the game is currently in a finished state.
         bool check_if_game_is_finished(Board& final_board);
+
+        // Checks if the game is finished. The check only runs again after a piece
+        // has been placed, otherwise the result of the last check is used.
+        bool is_finished();
+
+        // Gets the board from the last end of game check, with the pieces each
+        // player can potentially place added to it.
+        const Board& get_final_board();
+
+        // Gets the score of each player on the final board.
+        const std::vector<float>& get_final_scores();
         
         // Given a board, simulates placing as many pieces as possible for a given actor.
         void simulate_filling_placements(Board& board, int id);
 
+        // Sets the number of threads used to simulate each actor's placements when
+        // checking if the game is finished. With one thread or less the actors are
+        // simulated one after the other. The results are the same either way.
+        void set_simulation_threads(int threads);
+
+        // Sets how the end of game check fills the board, which is a greedy fill
+        // unless set otherwise.
+        void set_scoring_mode(scoring_mode mode);
+
+        // Records every placement made from now on with a writer that has already
+        // begun a game, or stops recording if the writer is null. The game doesn't
+        // own the writer.
+        void set_record_writer(GameRecordWriter* record_writer);
+
     private:
 
+        // Lets the engine benchmarks measure the private rule checks on their own.
+        friend class EngineBenchmark;
+
+        // What a move changed, so it can be undone. Piece keys already tell
+        // owners apart only while there are fewer than 256 of them.
+        struct Undo {
+            Placement placement;
+            std::uint8_t actor;
+            std::uint8_t half_squares_placed;
+
+            // The actor's points around the slot before the move.
+            std::uint16_t touching;
+        };
+
         // Describes a position on the board and allows for comparison.
         struct board_pos {
             int i;
@@ -50,44 +190,84 @@ class Game {
             friend auto operator<=>(const board_pos&, const board_pos&) = default;
         };
 
-        int blocks_;
-        // Since only human players are currently implemented, actors and players 
-        // mean the same thing.
+        // Actors are either players at the mouse or computer players.
         int num_actors_;
         int current_actor_turn_;
         int half_squares_placed_;
-        std::vector<Player> players_;
+        std::vector<std::unique_ptr<Actor>> actors_;
         Board board_;
         InputHandler* input_handler_;
         Cursor current_cursor_;
+        GameRecordWriter* record_writer_;
+
+        // The moves that can be undone, with the last move made at the back.
+        std::vector<Undo> undo_stack_;
+
+        // Results of the last end of game check, which are only out of date
+        // once a piece is placed.
+        bool is_end_state_outdated_;
+        bool is_finished_;
+        Board final_board_;
+        std::vector<float> final_scores_;
+
+        // The slots each actor can still reach, found before simulating anything.
+        std::vector<ReachableRegion> reachable_regions_;
+
+        // Boards reused by each end of game check to simulate each actor's placements.
+        std::vector<Board> simulated_boards_;
+
+        // The slots left to try to fill for each actor while simulating their
+        // placements, one bit for each slot.
+        std::vector<std::vector<Board::bitboard>> fill_frontiers_;
+
+        scoring_mode scoring_mode_;
+
+        // A solver for each actor's maximum fill, which are only made once they're used.
+        std::vector<std::unique_ptr<FillSolver>> fill_solvers_;
+
+        // Threads for simulating actors in parallel, if enabled.
+        std::unique_ptr<ThreadPool> simulation_pool_;
+
+        // Reruns the end of game check if the board changed since the last check.
+        void update_end_state();
 
         void reset_cursor(int id);
 
         // Switches the piece used for the cursor
         void toggle_cursor_piece();
 
+        // Switches the cursor to its piece rotated by 90 degrees.
+        void rotate_cursor_piece(Piece::rotation rot);
+
         // Gets the id of the actor who's turn is next
         int get_next_actor();
 
-        // Checks if a given piece can fit within a board slot.
-        bool check_if_space_in_board_slot(std::shared_ptr<Piece> piece, int x, int y,
+        // Places a valid placement for the actor whose turn it is and moves the
+        // turn on once it's used up.
+        void apply_placement(const Placement& placement);
+
+        // Checks if a given shape can fit within a board slot.
+        bool check_if_space_in_board_slot(shape_id shape, int x, int y,
             const Board& target_board) const;
 
-        // Checks if a player can place a piece based on pieces placed on
+        // Checks if a player can place a shape based on pieces placed on
         // their turn.
-        bool check_if_sufficient_half_squares_left(std::shared_ptr<Piece> piece,
-            int half_squares_placed) const;
+        static bool check_if_sufficient_half_squares_left(shape_id shape,
+            int half_squares_placed);
 
         // Checks if a piece placement would be connected to the player's other pieces.
-        bool check_if_connected_to_existing_pieces(std::shared_ptr<Piece> piece, int x, int y,
+        bool check_if_connected_to_existing_pieces(int owner, shape_id shape, int x, int y,
             const Board& target_board) const;
 
-        // Returns if any points in `points1` and `points2` are the same.
-        bool compare_points(std::vector<Piece::Point> points1, std::vector<Piece::Point> points2) const;
+        // Calls `visit` with each valid placement for an owner until it returns false.
+        template <typename Visitor>
+        static void visit_valid_placements(int owner, int half_squares_placed,
+            const Board& target_board, Visitor&& visit);
 
-        // Attempts to fill a slot by placing a new piece and returns true if 
-        // successful.
-        bool fill_slot(Board& board, const Board::board_slot& slot, int id, int i, int j);
+        // Attempts to fill the slot at x and y by placing a new piece for `id` and
+        // returns true if successful. The first shape that is a valid placement
+        // is placed.
+        bool fill_slot(Board& board, int id, int x, int y);
 
         // Finds the location of the mouse on the board using the world space coordinates
         // of the mouse.
@@ -1,27 +1,58 @@
 #ifndef input_handler_hpp
 #define input_handler_hpp
 
-#include <map>
-#include <vector>
+#include <array>
+#include <chrono>
 
-// Handles mouse and keyboard inputs by storing mouse and keyboard.
-// This class is meant to be used in the glfw callback functions.
+#include "input/keys.hpp"
+#include "util/spsc_queue.hpp"
+
+// Handles mouse and keyboard inputs. The glfw callback functions push events
+// as they happen, and whoever acts on the input takes them in the same order,
+// so quick clicks or scrolls between frames are neither lost nor merged.
 class InputHandler {
 
     public:
-        // Handler is a map of key presses
-        using handler_type = std::map<int, bool>;
+        using clock = std::chrono::steady_clock;
+
+        // Something that happened to a key or the mouse's scroll wheel and when.
+        struct Event {
+            enum class event_type {
+                press,
+                release,
+                scroll
+            };
+
+            event_type type;
+            int key;
+            double yoffset;
+            clock::time_point time;
+        };
+
+        // The most events that can wait to be taken. Events that happen while
+        // the queue is full are dropped.
+        static constexpr std::size_t event_capacity = 256;
 
-        InputHandler() = default;
+        // Presses of a key that come sooner than this after the last press are
+        // treated as the switch of the mouse or key bouncing and are ignored.
+        static constexpr std::chrono::milliseconds debounce_time{30};
 
-        // Initializer handler with a given set of keys to consider
-        InputHandler(std::vector<int> keys);
+        InputHandler();
 
-        // Get if a key is pressed 
+        // Get if a key is pressed, as of the last event that was taken.
         bool get_key_state(int key) const;
 
-        // Set if a key is pressed
-        void set_key_state(int key, bool isPressed);
+        // Adds a key being pressed or released at a given time to the events.
+        void push_key_event(int key, bool isPressed, clock::time_point time = clock::now());
+
+        // Adds the mouse's scroll wheel moving at a given time to the events.
+        void push_scroll_event(double yoffset, clock::time_point time = clock::now());
+
+        // Takes the next press or scroll event and returns true, or returns false
+        // if there are none left. Releases, presses of keys that are already held
+        // down and presses that are bounces are used to keep track of the state of
+        // the keys, but aren't returned.
+        bool poll_event(Event& event);
 
         // Gets the current mouse x position in the world space in terms of block widths.
         double get_mouse_xpos() const;
@@ -35,17 +66,15 @@ class InputHandler {
         // Sets the mouse y position in the world space in terms of block widths.
         void set_mouse_ypos(double ypos);
 
-        // Gets the current y offset of the mouse's scroll wheel.
-        double get_mouse_scroll_yoffset() const;
+    private:
+        SpscQueue<Event, event_capacity> events_;
 
-        // Sets the mouse's scroll wheel yoffset.
-        void set_mouse_scroll_yoffset(double yoffset);
+        // The state of every key by its code.
+        std::array<bool, key_code_count> is_key_pressed_;
+        std::array<clock::time_point, key_code_count> last_press_;
 
-    private:
-        handler_type keys_;
         double mouse_xpos_;
         double mouse_ypos_;
-        double mouse_yoffset_;
 };
 
 #endif 
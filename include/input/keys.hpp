@@ -0,0 +1,14 @@
+#ifndef keys_hpp
+#define keys_hpp
+
+// Codes of the keys and mouse buttons that the game responds to. These have the
+// same values as the GLFW codes, so codes from GLFW callbacks can be given to an
+// input handler as they are without the game depending on GLFW.
+inline constexpr int mouse_button_left = 0;
+inline constexpr int mouse_button_right = 1;
+
+// One more than the largest key code, which is the code of the last key GLFW has.
+// Mouse buttons have the codes below the first key.
+inline constexpr int key_code_count = 349;
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef game_record_hpp
+#define game_record_hpp
+
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "game.hpp"
+#include "components/board.hpp"
+
+// Games are recorded in a compact binary format so every game can be kept.
+// A file starts with `record_magic` and `record_version`, followed by any number
+// of games. Each game starts with the board size, the number of players and the
+// seed, followed by its placements and then a zero. Every number is written as
+// a variable length integer with seven bits per byte, lowest bits first.
+//
+// A placement is written as (y * size + x) * shape_count + shape + 1, so it
+// takes one byte in the first slots and two bytes on boards of up to 42 slots
+// on each side. Whose turn it is follows from the placements, since turns move
+// on after a square or two halves.
+
+inline constexpr std::array<char, 4> record_magic = {'B', 'K', 'G', 'R'};
+inline constexpr std::uint8_t record_version = 1;
+
+// What a recorded game was played with.
+struct GameRecordHeader {
+    int blocks = Board::default_board_size;
+    int players = 2;
+    std::uint64_t seed = 0;
+};
+
+// Writes games to a stream. Placements can be added by hand or by giving the
+// writer to a game with `Game::set_record_writer`.
+class GameRecordWriter {
+
+    public:
+        // Writes the start of the file.
+        GameRecordWriter(std::ostream& out);
+
+        // Starts recording a game.
+        // Precondition: no game is being recorded
+        void begin_game(const GameRecordHeader& header);
+
+        // Records the next placement of the game.
+        // Precondition: a game is being recorded and the placement is on its board
+        void add_placement(const Game::Placement& placement);
+
+        // Finishes recording the game.
+        // Precondition: a game is being recorded
+        void end_game();
+
+    private:
+        std::ostream& out_;
+        int blocks_;
+        bool is_recording_;
+
+        void write_number(std::uint64_t value);
+};
+
+// Reads games from a stream a block at a time, so files of any size can be
+// read without loading them.
+class GameRecordReader {
+
+    public:
+        // Reads the start of the file.
+        GameRecordReader(std::istream& in);
+
+        // Checks if the stream is a game record that could be read so far.
+        bool is_valid() const;
+
+        // Starts reading the next game, skipping the rest of the current game.
+        // Returns false once there are no more games or the record is invalid.
+        bool next_game(GameRecordHeader& header);
+
+        // Reads the next placement of the current game. Returns false at the end
+        // of the game or if the record is invalid.
+        bool next_placement(Game::Placement& placement);
+
+    private:
+        std::istream& in_;
+        std::vector<char> buffer_;
+        std::size_t position_;
+        std::size_t size_;
+
+        bool is_valid_;
+        bool is_in_game_;
+        int blocks_;
+
+        // Reads the next byte. Returns false at the end of the stream.
+        bool read_byte(std::uint8_t& byte) {
+            if (position_ == size_ && !fill_buffer()) {
+                return false;
+            }
+
+            byte = buffer_[position_++];
+            return true;
+        }
+
+        bool fill_buffer();
+
+        bool read_number(std::uint64_t& value);
+};
+
+// Plays recorded games back onto a board as fast as it can. The placements are
+// trusted to be valid apart from fitting in their slot, so none of the rules
+// are checked.
+class GameReplayer {
+
+    public:
+        GameReplayer(std::istream& in);
+
+        // Starts the next game on an empty board. Returns false once there are
+        // no more games.
+        bool next_game();
+
+        // Places the next placement of the game. Returns false at the end of the
+        // game or if the placement doesn't fit.
+        bool step();
+
+        // Places the rest of the placements of the game. Returns the number of
+        // placements made.
+        int replay_game();
+
+        // Checks if everything read so far is a valid record.
+        bool is_valid() const;
+
+        const GameRecordHeader& get_header() const;
+
+        const Board& get_board() const;
+
+        // Gets whose turn it is and how much of their turn they've used.
+        int get_current_actor() const;
+        int get_half_squares_placed() const;
+
+    private:
+        GameRecordReader reader_;
+        GameRecordHeader header_;
+        Board board_;
+        bool is_valid_;
+
+        int current_actor_;
+        int half_squares_placed_;
+};
+
+#endif
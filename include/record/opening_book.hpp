@@ -0,0 +1,112 @@
+#ifndef opening_book_hpp
+#define opening_book_hpp
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "game.hpp"
+#include "components/board.hpp"
+#include "util/mapped_file.hpp"
+
+// An opening book has the placement to play in positions near the start of the
+// game, found ahead of time by searching each position deeply. A book file has
+// a header and then an entry for each position, sorted by the key of the
+// position so a position is found with a binary search straight from a memory
+// mapped file. Numbers are stored in the byte order of the machine that wrote them.
+//
+// Reflecting the board over the diagonal from its bottom left to its top right,
+// which is where both initial squares are, turns the slot at (x,y) into the slot
+// at (size-1-y,size-1-x). Every position plays the same as its reflection, so a
+// position and its reflection are one entry in the book, stored under the
+// smaller of their keys with its placement reflected to match.
+
+// Gets the slot and shape that a placement becomes when the board is reflected.
+// Reflecting twice gives back the same placement.
+Game::Placement reflect_placement(const Game::Placement& placement, int blocks);
+
+// Places the pieces of a board on another board, reflected. The other board is
+// cleared first.
+// Precondition: both boards have the same size and players
+void reflect_board(const Board& board, Board& reflected);
+
+// Gets the key of a position in an opening book, which is the same for the
+// position and its reflection. Sets `is_reflected` if the position is stored
+// as its reflection.
+std::uint64_t get_book_key(const Board& board, int actor, int half_squares_placed,
+    bool& is_reflected);
+
+// Collects the placement to play in each position, then writes them to a book.
+class OpeningBookWriter {
+
+    public:
+        // Precondition: blocks is in range [2,1024] and players is at least 2
+        OpeningBookWriter(int blocks, int players);
+
+        // Adds the placement to play in a position and how many plies deep it
+        // was searched. A position that's already in the book, or whose
+        // reflection is, keeps the placement it has.
+        // Precondition: the board has the book's size and players
+        void add_move(const Board& board, int actor, int half_squares_placed,
+            const Game::Placement& placement, int depth);
+
+        // Checks if a position or its reflection is already in the book.
+        bool contains(const Board& board, int actor, int half_squares_placed) const;
+
+        // Writes the book to a file. Returns false if it can't be written.
+        bool write(const std::string& path) const;
+
+        std::uint64_t get_move_count() const;
+
+    private:
+        struct Move {
+            Game::Placement placement;
+            int depth;
+        };
+
+        int blocks_;
+        int players_;
+
+        // The placement for each book key, already reflected to match the key.
+        std::unordered_map<std::uint64_t, Move> moves_;
+};
+
+// Reads an opening book by mapping it into memory, so opening a book doesn't
+// read or parse any of it.
+class OpeningBook {
+
+    public:
+        OpeningBook();
+
+        // Maps a book into memory. Returns false if it can't be read or isn't an
+        // opening book.
+        bool open(const std::string& path);
+
+        void close();
+
+        // Gets the number of positions in the book.
+        std::uint64_t size() const;
+
+        int get_board_size() const;
+        int get_players() const;
+
+        // Finds the placement to play in a position and how deep it was searched.
+        // Returns false if the position isn't in the book, such as when the board
+        // has a different size from the book.
+        bool find(const Board& board, int actor, int half_squares_placed,
+            Game::Placement& placement, int& depth) const;
+
+        bool find(const Board& board, int actor, int half_squares_placed,
+            Game::Placement& placement) const;
+
+    private:
+        MappedFile file_;
+
+        int blocks_;
+        int players_;
+        std::uint64_t count_;
+        const unsigned char* entries_;
+};
+
+#endif
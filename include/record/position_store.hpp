@@ -0,0 +1,204 @@
+#ifndef position_store_hpp
+#define position_store_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "game.hpp"
+#include "components/board.hpp"
+#include "util/mapped_file.hpp"
+
+// Positions are stored on disk as fixed size records so any of them can be read
+// straight from a memory mapped file. A file has a header, the records in the
+// order they were added, and an index of their keys sorted for looking up
+// positions by key.
+//
+// A record has the key of the position, whose turn it is, how many half squares
+// they've placed, every player's final score as four bytes of half squares, and
+// then two bytes for each slot of the board. The two bytes are the first and
+// second piece in the slot, each 0 if there is no piece or
+// 1 + owner * shape_count + shape otherwise. Records are padded to a multiple of
+// eight bytes. Numbers are stored in the byte order of the machine that wrote
+// them.
+
+// The most players a position store can have, so every piece fits in a byte.
+inline constexpr int max_position_store_players = 255 / shape_count;
+
+// A position stored in a `PositionStore`. Views read from the store's memory and
+// are only valid while the store is open.
+class PositionView {
+
+    public:
+        PositionView(const unsigned char* data, int blocks, int players);
+
+        // Gets the key of the position, which is `Game::get_key()` of the game it
+        // was taken from.
+        std::uint64_t get_key() const;
+
+        // Gets whose turn it is and how much of their turn they've used.
+        int get_current_actor() const;
+        int get_half_squares_placed() const;
+
+        // Gets a player's score at the end of the game the position was taken from.
+        float get_final_score(int player) const;
+
+        // Gets the pieces in the slot at x and y in the order they were placed.
+        // Precondition: x and y are in range [0,size)
+        Board::slot_contents get_slot(int x, int y) const;
+
+        // Places the pieces of the position on a board, which is cleared first.
+        // Precondition: the board has the size and players of the store
+        void copy_to_board(Board& board) const;
+
+    private:
+        const unsigned char* data_;
+        int blocks_;
+        int players_;
+};
+
+// Writes positions to a new position store. Positions are written to the file as
+// they're added, and only their keys are kept until the store is finished.
+class PositionStoreWriter {
+
+    public:
+        // Precondition: blocks is in range [2,1024] and players is in range
+        // [2,max_position_store_players]
+        PositionStoreWriter(int blocks, int players);
+
+        // Creates the file. Returns false if it can't be created.
+        bool open(const std::string& path);
+
+        // Adds a position along with the final scores of its game.
+        // Precondition: the store is open and the board has the store's size
+        // and players
+        void add_position(const Board& board, std::uint64_t key, int current_actor,
+            int half_squares_placed, const std::vector<float>& final_scores);
+
+        // Adds the current position of a game.
+        void add_position(const Game& game, const std::vector<float>& final_scores);
+
+        // Writes the index and closes the file. Returns false if anything couldn't
+        // be written.
+        bool finish();
+
+        std::uint64_t get_position_count() const;
+
+    private:
+        int blocks_;
+        int players_;
+        std::size_t record_size_;
+
+        std::ofstream out_;
+
+        // The key of every record paired with its place in the file.
+        std::vector<std::pair<std::uint64_t, std::uint64_t>> keys_;
+
+        // Reused to build each record before it's written.
+        std::vector<unsigned char> record_;
+};
+
+// Reads a position store by mapping it into memory, so reading a position
+// doesn't copy anything.
+class PositionStore {
+
+    public:
+        // Goes through the positions in the order they were added.
+        class iterator {
+
+            public:
+                using iterator_category = std::random_access_iterator_tag;
+                using value_type = PositionView;
+                using difference_type = std::ptrdiff_t;
+                using pointer = void;
+                using reference = PositionView;
+
+                iterator() = default;
+                iterator(const PositionStore* store, std::uint64_t index)
+                    : store_(store), index_(index) {}
+
+                PositionView operator*() const {
+                    return (*store_)[index_];
+                }
+
+                iterator& operator++() {
+                    ++index_;
+                    return *this;
+                }
+
+                iterator operator++(int) {
+                    iterator old = *this;
+                    ++index_;
+                    return old;
+                }
+
+                iterator& operator+=(difference_type offset) {
+                    index_ += offset;
+                    return *this;
+                }
+
+                friend iterator operator+(iterator it, difference_type offset) {
+                    return it += offset;
+                }
+
+                friend difference_type operator-(const iterator& lhs, const iterator& rhs) {
+                    return static_cast<difference_type>(lhs.index_ - rhs.index_);
+                }
+
+                friend bool operator==(const iterator& lhs, const iterator& rhs) {
+                    return lhs.index_ == rhs.index_;
+                }
+
+            private:
+                const PositionStore* store_ = nullptr;
+                std::uint64_t index_ = 0;
+        };
+
+        PositionStore();
+
+        // Maps a store into memory. Returns false if it can't be read or isn't a
+        // position store.
+        bool open(const std::string& path);
+
+        void close();
+
+        // Gets the number of positions.
+        std::uint64_t size() const;
+
+        int get_board_size() const;
+        int get_players() const;
+
+        // Gets the position that was added `index` positions after the first.
+        // Precondition: index is in range [0,size)
+        PositionView operator[](std::uint64_t index) const;
+
+        // Finds the first position added with a key. Returns -1 if there are no
+        // positions with the key.
+        std::int64_t find(std::uint64_t key) const;
+
+        iterator begin() const;
+        iterator end() const;
+
+    private:
+        // An entry of the index, which is sorted by key and then by record.
+        struct IndexEntry {
+            std::uint64_t key;
+            std::uint64_t record;
+        };
+
+        MappedFile file_;
+
+        int blocks_;
+        int players_;
+        std::size_t record_size_;
+        std::uint64_t count_;
+        const unsigned char* records_;
+        const unsigned char* index_;
+
+        IndexEntry get_index_entry(std::uint64_t entry) const;
+};
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef board_renderer_hpp
+#define board_renderer_hpp
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "components/board.hpp"
+#include "components/shapes.hpp"
+#include "game.hpp"
+
+// Structure for storing a colour
+struct Color {
+    float r, g, b, a;
+};
+
+// Given an id returns the associated colour for that player
+Color get_player_color(int id);
+
+// Draws the board from vertex buffers that are kept on the graphics card. The
+// pieces of the board are only rebuilt when the board changes and are drawn
+// with a single call, as are the grid lines, while the cursor has its own small
+// buffer. This needs the OpenGL context to be current whenever it's used.
+//
+// Frames are only drawn when something changed. When only the cursor moved, just
+// the slots it was in and is now in are drawn again.
+class BoardRenderer {
+
+    public:
+        // A corner of a triangle with its position in world space and its colour.
+        struct Vertex {
+            float x, y;
+            Color color;
+        };
+
+        // Creates the buffers for a board with `blocks` slots on each side that
+        // are each `block_width` wide.
+        BoardRenderer(int blocks, float block_width);
+
+        ~BoardRenderer();
+
+        BoardRenderer(const BoardRenderer&) = delete;
+        BoardRenderer& operator=(const BoardRenderer&) = delete;
+
+        // Sets the board to draw. The pieces are only rebuilt if it's a different
+        // board or the board has changed since it was last set.
+        void set_board(const Board& board);
+
+        // Sets the cursor to draw over the board.
+        void set_cursor(const Game::Cursor& cursor);
+
+        // Stops drawing the cursor until it's set again.
+        void hide_cursor();
+
+        // Makes the next frames draw everything, such as when the window was
+        // resized or uncovered.
+        void redraw_all();
+
+        // Draws what has changed since the frame in the back buffer. Returns false
+        // if nothing has changed, in which case the buffers don't need swapping.
+        bool draw_changes();
+
+        // Clears the frame and draws the pieces, then the cursor, then the lines
+        // of the board.
+        void draw() const;
+
+        // Adds the two triangles or one triangle of a shape in the slot at x and y.
+        static void add_shape_vertices(std::vector<Vertex>& vertices, shape_id shape, int x,
+            int y, int blocks, float block_width, Color color);
+
+        // Adds the triangles of every piece on a board.
+        static void add_board_vertices(std::vector<Vertex>& vertices, const Board& board,
+            float block_width);
+
+    private:
+        // Where the cursor is drawn, if it's drawn at all.
+        struct CursorState {
+            bool is_shown = false;
+            Game::Placement placement{0, 0, triangle_shape};
+            int player_id = 0;
+
+            friend bool operator==(const CursorState& lhs, const CursorState& rhs) {
+                return lhs.is_shown == rhs.is_shown && lhs.player_id == rhs.player_id
+                    && lhs.placement.x == rhs.placement.x && lhs.placement.y == rhs.placement.y
+                    && lhs.placement.shape == rhs.placement.shape;
+            }
+        };
+
+        int blocks_;
+        float block_width_;
+
+        // Names of the buffers on the graphics card.
+        unsigned int board_buffer_;
+        unsigned int cursor_buffer_;
+        unsigned int line_buffer_;
+
+        int board_vertex_count_;
+        int cursor_vertex_count_;
+        int line_vertex_count_;
+
+        // What the buffers were last built from, to tell when they're out of date.
+        // The board is only compared by address.
+        const Board* board_;
+        std::uint64_t board_generation_;
+        CursorState cursor_;
+
+        // The cursor in the last two frames that were drawn. The back buffer is
+        // one of those frames, depending on whether swapping exchanges the
+        // buffers or copies the back buffer to the front.
+        std::array<CursorState, 2> drawn_cursors_;
+
+        // How many more frames have to be drawn in full so that both buffers
+        // are up to date.
+        int full_redraws_;
+
+        // Reused to build the vertices before they're uploaded.
+        std::vector<Vertex> vertices_;
+
+        // Draws the vertices of a buffer as triangles or lines.
+        void draw_buffer(unsigned int buffer, int vertex_count, unsigned int mode) const;
+
+        // Limits drawing to the pixels of the slot at x and y, along with the
+        // lines around it.
+        void scissor_slot(int x, int y) const;
+};
+
+#endif
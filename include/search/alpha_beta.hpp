@@ -0,0 +1,87 @@
+#ifndef alpha_beta_hpp
+#define alpha_beta_hpp
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "game.hpp"
+#include "components/board.hpp"
+#include "search/transposition_table.hpp"
+#include "util/thread_pool.hpp"
+
+// Finds the best turn for an actor with iterative deepening alpha-beta search.
+// Every ply places one shape, so a turn is one or two plies. With more than
+// one actor to beat, every other actor is assumed to play against the actor
+// that is searching.
+//
+// Searching with more than one thread uses Lazy SMP: every thread searches the
+// same position and they share what they find through a transposition table,
+// with half of the helper threads a ply deeper than the main thread.
+class AlphaBetaSearch {
+
+    public:
+        // How long a search can run for. A search always finishes at least one
+        // ply, even if that takes longer.
+        struct Limits {
+            int threads = 1;
+
+            // Zero means no limit.
+            std::chrono::milliseconds time{1000};
+            std::uint64_t nodes = 0;
+
+            int max_depth = 64;
+
+            // Size of the transposition table.
+            std::size_t table_megabytes = 64;
+        };
+
+        // The placements of the best turn found, which are one square or up to
+        // two halves.
+        struct Turn {
+            std::array<Game::Placement, 2> placements;
+            int count = 0;
+
+            // Score of the turn for the searching actor and the deepest number
+            // of plies searched in full.
+            int score = 0;
+            int depth = 0;
+            std::uint64_t nodes = 0;
+        };
+
+        AlphaBetaSearch(const Limits& limits);
+
+        ~AlphaBetaSearch();
+
+        // Searches for the best turn of `actor` on `board` when it has placed
+        // `half_squares_placed` half squares this turn. The turn has no
+        // placements if the actor has no valid placement.
+        Turn search(const Board& board, int num_actors, int actor, int half_squares_placed);
+
+        // Stops a search running on another thread as soon as possible, along
+        // with every later search, once the searches are no longer needed.
+        void cancel();
+
+    private:
+        // The search state of one thread.
+        class Searcher;
+
+        Limits limits_;
+        TranspositionTable table_;
+        std::unique_ptr<ThreadPool> pool_;
+        std::vector<std::unique_ptr<Searcher>> searchers_;
+
+        // Shared between the threads of a search.
+        std::atomic<bool> is_stopping_;
+        std::atomic<bool> is_cancelled_;
+        std::atomic<std::uint64_t> nodes_;
+        std::chrono::steady_clock::time_point deadline_;
+
+        // Set from the main thread at the end of each finished iteration.
+        Turn best_turn_;
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef fill_solver_hpp
+#define fill_solver_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "game.hpp"
+#include "components/board.hpp"
+#include "components/shapes.hpp"
+#include "search/reachable_region.hpp"
+#include "search/transposition_table.hpp"
+
+// Finds the most half squares an actor can place on a board when nobody else
+// places anything, along with the pieces that place them.
+//
+// The search goes depth first through one placement at a time and cuts off any
+// position that can't beat the best fill found so far. How much a position can
+// still add is bounded by the half squares free in the actor's reachable region,
+// and positions that have been searched before are looked up in a transposition
+// table. The search stops as soon as a fill reaches the bound of the board it
+// started from.
+class FillSolver {
+
+    public:
+        // Creates a solver whose transposition table uses about `table_megabytes`
+        // of memory.
+        FillSolver(std::size_t table_megabytes);
+
+        // Places the pieces of the best fill of `id` on `board`. Returns the
+        // number of half squares that were placed.
+        // Precondition: id is in range [0,players of the board)
+        int solve(Board& board, int id);
+
+        // Gets an upper bound on the half squares `id` could still place on `board`.
+        int get_upper_bound(const Board& board, int id);
+
+        // Gets the number of placements made by the last solve.
+        std::uint64_t get_nodes() const;
+
+    private:
+        // The state of one placement deep in the search.
+        struct Frame {
+            // The next slot and shape to try to place.
+            int next_slot;
+            shape_id next_shape;
+
+            // Half squares placed since the board the search started from.
+            int placed;
+
+            // Whether anything has been placed on the frame's board yet.
+            bool has_placed;
+        };
+
+        TranspositionTable table_;
+        std::uint64_t nodes_;
+
+        // The board of each frame, which are reused between solves so only the
+        // first solve on a board size allocates.
+        std::vector<Board> boards_;
+        std::vector<Frame> frames_;
+        Board best_board_;
+
+        // The region used to bound each board.
+        ReachableRegion region_;
+
+        // Gets the next valid placement for `id` of a frame in order of slot and
+        // then shape, and moves the frame past it. Returns false if there isn't one.
+        static bool next_placement(const Board& board, int id, Frame& frame,
+            Game::Placement& placement);
+};
+
+#endif
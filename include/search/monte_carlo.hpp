@@ -0,0 +1,123 @@
+#ifndef monte_carlo_hpp
+#define monte_carlo_hpp
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "game.hpp"
+#include "components/board.hpp"
+#include "util/thread_pool.hpp"
+
+// Finds the best turn for an actor with Monte Carlo tree search. Every node of
+// the tree places one shape, and each playout places random valid placements
+// until no actor can place anything, which is when the game has to be finished.
+// The actor with the highest score at that point wins the playout.
+//
+// Searching with more than one thread grows one shared tree. Threads add a
+// virtual loss to the nodes they're going through so other threads spread out
+// to other nodes, and nodes are expanded without locks by the first thread to
+// claim them, with the children taken from a pool of nodes made up front.
+class MonteCarloSearch {
+
+    public:
+        // How long a search can run for. A search always runs at least one playout.
+        struct Limits {
+            int threads = 1;
+
+            // Zero means no limit.
+            std::chrono::milliseconds time{1000};
+            std::uint64_t playouts = 0;
+
+            // The most nodes the tree can have. Nodes stop being expanded once
+            // the pool runs out.
+            int max_nodes = 1 << 20;
+
+            // How much the search explores placements that haven't done well.
+            double exploration = 1.4;
+
+            // How many losing visits a thread adds to each node it goes through
+            // until its playout finishes.
+            int virtual_loss = 3;
+
+            std::uint64_t seed = 0;
+        };
+
+        // The placements of the best turn found, which are one square or up to
+        // two halves.
+        struct Turn {
+            std::array<Game::Placement, 2> placements;
+            int count = 0;
+
+            // The share of playouts through the first placement that the actor
+            // won, with draws counting as half.
+            double win_rate = 0;
+            std::uint64_t playouts = 0;
+        };
+
+        MonteCarloSearch(const Limits& limits);
+
+        ~MonteCarloSearch();
+
+        // Searches for the best turn of `actor` on `board` when it has placed
+        // `half_squares_placed` half squares this turn. The turn has no
+        // placements if the actor has no valid placement.
+        Turn search(const Board& board, int num_actors, int actor, int half_squares_placed);
+
+        // Stops a search running on another thread as soon as possible, along
+        // with every later search, once the searches are no longer needed.
+        void cancel();
+
+    private:
+        // The search state of one thread.
+        class Worker;
+
+        // Nodes that are being expanded by another thread, or that can't be
+        // expanded because the pool ran out, have playouts run from them.
+        enum node_state : std::uint8_t {
+            unexpanded,
+            expanding,
+            expanded,
+            out_of_nodes
+        };
+
+        struct Node {
+            // The placement made to get to the node and who made it. The root
+            // has no actor.
+            Game::Placement placement;
+            int actor;
+
+            // Visits include the virtual losses of playouts that haven't finished.
+            std::atomic<int> visits;
+
+            // Twice the playouts won by the actor, plus one for every draw.
+            std::atomic<std::int64_t> reward;
+
+            // The children are next to each other in the pool. They can only be
+            // read once the node is expanded.
+            int first_child;
+            int child_count;
+            std::atomic<node_state> state;
+        };
+
+        Limits limits_;
+        std::unique_ptr<Node[]> nodes_;
+        std::atomic<int> next_node_;
+
+        std::unique_ptr<ThreadPool> pool_;
+        std::vector<std::unique_ptr<Worker>> workers_;
+
+        // Shared between the threads of a search.
+        std::atomic<bool> is_stopping_;
+        std::atomic<bool> is_cancelled_;
+        std::atomic<std::uint64_t> playouts_;
+        std::chrono::steady_clock::time_point deadline_;
+
+        // Gets the most visited child of a node, or -1 if it has none.
+        int get_most_visited_child(int node) const;
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef reachable_region_hpp
+#define reachable_region_hpp
+
+#include <cstdint>
+#include <vector>
+
+#include "components/board.hpp"
+
+// The slots an actor could still place pieces in if nobody else placed
+// anything. A slot is reached once a point of the actor's pieces is a point of
+// its free part, and then every slot that shares a point with the free part of
+// a reached slot is reached too, as if filling a slot gave the actor every
+// point of its free part.
+//
+// Filling a board for an actor fills every slot of its region in full, so the
+// region is both where the actor's fill goes and how much it places, found in
+// one pass over the board without placing anything.
+class ReachableRegion {
+
+    public:
+        // Finds the region of `id` on `board`, replacing the last one found.
+        // Returns the number of half squares that are free in the region.
+        int compute(const Board& board, int id);
+
+        // Gets the number of half squares that were free in the last region found.
+        int get_free_halves() const;
+
+        // Checks if the slot at x and y is in the region.
+        // Precondition: x and y are in range [0,size of the last board)
+        bool contains(int x, int y) const;
+
+        // Checks if any slot is in both regions.
+        // Precondition: both regions were found on boards of the same size
+        bool intersects(const ReachableRegion& other) const;
+
+        // Gets the points of a slot that a piece could have in its free part,
+        // along with how many half squares of the slot are free.
+        static std::uint16_t get_free_points(const Board::slot_contents& slot, int& free_halves);
+
+    private:
+        int size_ = 0;
+        int free_halves_ = 0;
+
+        // One bit for each slot of the region, and the slots whose neighbours
+        // haven't been looked at yet while finding it. Both are reused so only
+        // the first region found on a board size allocates.
+        std::vector<Board::bitboard> slots_;
+        std::vector<int> pending_slots_;
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef transposition_table_hpp
+#define transposition_table_hpp
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "game.hpp"
+
+// A table of search results by position key that many threads can read and
+// write at once without locks. Each slot keeps the key xor'd with the data
+// next to the data itself, so a slot torn by two threads writing at once no
+// longer matches its key and is treated as empty.
+class TranspositionTable {
+
+    public:
+        // How a stored score bounds the real score of a position.
+        enum class bound : std::uint8_t {
+            exact,
+            lower,
+            upper
+        };
+
+        // The largest magnitude of score that can be stored.
+        static constexpr int max_score = (1 << 27) - 1;
+
+        struct Entry {
+            int score;
+            int depth;
+            bound type;
+
+            // The best placement found, if any.
+            bool has_move;
+            Game::Placement move;
+        };
+
+        // Creates a table that uses about `megabytes` of memory. The number of
+        // slots is rounded down to a power of two.
+        TranspositionTable(std::size_t megabytes);
+
+        // Looks up the entry for a key. Returns false if there isn't one.
+        bool probe(std::uint64_t key, Entry& entry) const;
+
+        // Stores an entry for a key. Entries for other keys are replaced, while
+        // an entry for the same key is only replaced by one that is as deep.
+        void store(std::uint64_t key, const Entry& entry);
+
+        // Removes every entry. No other thread can use the table meanwhile.
+        void clear();
+
+    private:
+        struct Slot {
+            std::atomic<std::uint64_t> check;
+            std::atomic<std::uint64_t> data;
+        };
+
+        std::unique_ptr<Slot[]> slots_;
+        std::size_t mask_;
+
+        static std::uint64_t pack(const Entry& entry);
+        static Entry unpack(std::uint64_t data);
+};
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef allocation_counter_hpp
+#define allocation_counter_hpp
+
+// Counts every allocation a program makes by replacing the global operator new.
+// Only the tests and benchmarks that check allocations link it in, and it's in
+// a file of its own so the replaced operators are never inlined into callers.
+
+// Gets the number of allocations made since the program started.
+long long get_allocation_count();
+
+#endif
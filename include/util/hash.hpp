@@ -0,0 +1,16 @@
+#ifndef hash_hpp
+#define hash_hpp
+
+#include <cstdint>
+
+// Mixes the bits of a value so that nearby values give unrelated results. This
+// is the finalizer of SplitMix64, which is cheap enough to compute random keys
+// on the fly instead of storing a table of them.
+constexpr std::uint64_t mix_bits(std::uint64_t value) {
+    value += 0x9E3779B97F4A7C15;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+    return value ^ (value >> 31);
+}
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef mapped_file_hpp
+#define mapped_file_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// A file mapped into memory for reading, so its contents can be used in place
+// without reading or parsing them first. The mapping uses POSIX mmap.
+class MappedFile {
+
+    public:
+        MappedFile();
+
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // Maps a file, replacing any file that was mapped before. Returns false
+        // if it can't be mapped or is smaller than `min_size` bytes.
+        bool open(const std::string& path, std::size_t min_size);
+
+        void close();
+
+        // Gets the contents of the file, which is null if no file is mapped.
+        const unsigned char* data() const;
+
+        std::size_t size() const;
+
+    private:
+        const unsigned char* data_;
+        std::size_t size_;
+};
+
+// Reads a value from file data, which may not be aligned for it.
+template <typename T>
+T load_unaligned(const unsigned char* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+// Writes a value to file data, which may not be aligned for it.
+template <typename T>
+void store_unaligned(unsigned char* data, T value) {
+    std::memcpy(data, &value, sizeof(T));
+}
+
+// Finds the first of `count` entries of `entry_size` bytes whose key isn't less
+// than `key`, with a binary search. Each entry starts with a 64 bit key and the
+// entries are sorted by it. Returns `count` if every key is less.
+std::uint64_t find_first_key(const unsigned char* entries, std::uint64_t count,
+    std::size_t entry_size, std::uint64_t key);
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef spsc_queue_hpp
+#define spsc_queue_hpp
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// A fixed size queue for one thread to push to while another thread pops from
+// it, without locks. The producer and consumer each keep a copy of the other's
+// index, so they only read each other's cache line when the queue looks full
+// or empty.
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+        "The capacity has to be a power of two");
+
+    public:
+        // Adds a value to the back of the queue. Only the producer can push.
+        // Returns false if the queue is full.
+        bool push(const T& value) {
+            const std::size_t tail = tail_.load(std::memory_order_relaxed);
+
+            if (tail - cached_head_ == Capacity) {
+                cached_head_ = head_.load(std::memory_order_acquire);
+
+                if (tail - cached_head_ == Capacity) {
+                    return false;
+                }
+            }
+
+            items_[tail & (Capacity - 1)] = value;
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Takes the value from the front of the queue. Only the consumer can pop.
+        // Returns false if the queue is empty.
+        bool pop(T& value) {
+            const std::size_t head = head_.load(std::memory_order_relaxed);
+
+            if (head == cached_tail_) {
+                cached_tail_ = tail_.load(std::memory_order_acquire);
+
+                if (head == cached_tail_) {
+                    return false;
+                }
+            }
+
+            value = items_[head & (Capacity - 1)];
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        // Owned by the consumer.
+        alignas(64) std::atomic<std::size_t> head_{0};
+        std::size_t cached_tail_ = 0;
+
+        // Owned by the producer.
+        alignas(64) std::atomic<std::size_t> tail_{0};
+        std::size_t cached_head_ = 0;
+
+        alignas(64) std::array<T, Capacity> items_{};
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef thread_pool_hpp
+#define thread_pool_hpp
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads that run batches of tasks. The threads are
+// created once and wait between batches, so running a batch doesn't have to
+// start any threads.
+class ThreadPool {
+
+    public:
+        // Creates a pool with a given number of worker threads.
+        ThreadPool(int threads);
+
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // Gets the number of worker threads in the pool.
+        int get_thread_count() const;
+
+        // Runs `task` once for every index in [0, count) and waits for every task
+        // to finish. The calling thread runs tasks along with the workers.
+        void run(int count, const std::function<void(int)>& task);
+
+    private:
+        std::vector<std::thread> threads_;
+
+        std::mutex mutex_;
+        std::condition_variable batch_started_;
+        std::condition_variable batch_finished_;
+
+        // The current batch of tasks.
+        const std::function<void(int)>* task_;
+        int task_count_;
+        std::atomic<int> next_task_;
+
+        // Counts batches so workers can tell when a new one has started.
+        std::uint64_t batch_;
+
+        // The number of workers that haven't finished the current batch.
+        int busy_workers_;
+
+        bool is_stopping_;
+
+        // Waits for batches and runs their tasks until the pool is destroyed.
+        void work();
+
+        // Runs tasks of the current batch until there are none left.
+        void run_tasks();
+};
+
+#endif
@@ -1,7 +1,6 @@
-#include <GLFW/glfw3.h>
-
 #include "actors/player.hpp"
 #include "input/input_handler.hpp"
+#include "input/keys.hpp"
 
 Player::Player(int id, InputHandler* input_handler) {
     input_handler_ = input_handler;
@@ -9,28 +8,39 @@ Player::Player(int id, InputHandler* input_handler) {
 
 Player::~Player() = default;
 
-// Chooses an action based on the current key states of the input handler.
-Action Player::do_action() {
-   
-    Action action = Action::NONE;
-
-    // Prioritize everything else over placements.
-    // The scroll offsets are integer values but given as doubles from glfw.
-    if (int(input_handler_->get_mouse_scroll_yoffset()) == -1) {
-        action = Action::ROTATE_CLOCKWISE;
-        // Reset scroll offset since it has been processed.
-        input_handler_->set_mouse_scroll_yoffset(0);
-    } else if (int(input_handler_->get_mouse_scroll_yoffset()) == 1) {
-        action = Action::ROTATE_COUNTERCLOCKWISE;
-        // Reset scroll offset since it has been processed.
-        input_handler_->set_mouse_scroll_yoffset(0);
-    } else if (input_handler_->get_key_state(GLFW_MOUSE_BUTTON_RIGHT)) {
-        action = Action::TOGGLE;
-    } else if (input_handler_->get_key_state(GLFW_MOUSE_BUTTON_LEFT)) {
-        action = Action::PLACE;
+// Chooses an action from the next press or scroll that the input handler has.
+// Each event gives at most one action, so no click or scroll is used twice.
+Action Player::do_action(const Game&) {
+
+    InputHandler::Event event;
+
+    while (input_handler_->poll_event(event)) {
+        switch (event.type) {
+
+            // The scroll offsets are whole numbers for a mouse wheel, but can be
+            // fractions for a touchpad.
+            case InputHandler::Event::event_type::scroll:
+                if (event.yoffset <= -1) {
+                    return Action::ROTATE_CLOCKWISE;
+                } else if (event.yoffset >= 1) {
+                    return Action::ROTATE_COUNTERCLOCKWISE;
+                }
+                break;
+
+            case InputHandler::Event::event_type::press:
+                if (event.key == mouse_button_right) {
+                    return Action::TOGGLE;
+                } else if (event.key == mouse_button_left) {
+                    return Action::PLACE;
+                }
+                break;
+
+            case InputHandler::Event::event_type::release:
+                break;
+        }
     }
 
-    return action;
+    return Action::NONE;
 }
 
 void Player::set_input_handler(InputHandler* input_handler) {
@@ -0,0 +1,23 @@
+#include "actors/random_player.hpp"
+
+RandomPlayer::RandomPlayer(std::uint64_t seed) : generator_(seed) {}
+
+bool RandomPlayer::choose_placement(const Game& game, Game::Placement& placement) {
+    const Board& board = game.get_board();
+    const int id = game.get_current_actor();
+    const int half_squares_placed = game.get_half_squares_placed();
+
+    // Collect every valid placement and pick one of them
+    const int count = Game::generate_placements(id, half_squares_placed, board, placements_);
+
+    if (count == 0) {
+        return false;
+    }
+
+    // Distributions can differ between standard libraries, while the generator
+    // itself doesn't, so use the generator directly to pick the same placements
+    // everywhere.
+    placement = placements_[generator_() % count];
+
+    return true;
+}
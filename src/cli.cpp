@@ -0,0 +1,298 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "game.hpp"
+#include "actors/random_player.hpp"
+#include "components/board.hpp"
+#include "components/shapes.hpp"
+#include "record/game_record.hpp"
+
+// Plays games without a window as fast as possible. Games are either played
+// by random players or follow a script of placements, and can be recorded.
+// Recorded games can also be replayed.
+
+struct Options {
+    int blocks = Board::default_board_size;
+    int players = 2;
+    int games = 1;
+    std::uint64_t seed = 0;
+    int threads = 1;
+    std::string script;
+    std::string record;
+    std::string replay;
+    bool quiet = false;
+    bool maximum_fill = false;
+};
+
+static void print_usage() {
+    std::cerr << "Usage: blockade_cli [options]\n"
+              << "  --size N      Number of blocks on each side of the board (default 8)\n"
+              << "  --players N   Number of players, which is only 2 for now (default 2)\n"
+              << "  --games N     Number of random games to play (default 1)\n"
+              << "  --seed N      Seed of the first random game, the next games use the\n"
+              << "                following seeds (default 0)\n"
+              << "  --threads N   Threads used to check if a game is finished (default 1)\n"
+              << "  --maximum-fill Score games by searching for the fill of the board that\n"
+              << "                places the most instead of filling it greedily\n"
+              << "  --script FILE Play the placements in FILE instead, one `x y shape` per\n"
+              << "                line where shape is a shape id. Use - to read from stdin\n"
+              << "  --record FILE Record the games that are played to FILE\n"
+              << "  --replay FILE Replay the games recorded in FILE instead\n"
+              << "  --quiet       Only print the summary\n";
+}
+
+// Reads the options from the arguments. Returns false if they're invalid.
+static bool parse_options(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* option = argv[i];
+        const bool has_value = i + 1 < argc;
+
+        if (std::strcmp(option, "--quiet") == 0) {
+            options.quiet = true;
+        } else if (std::strcmp(option, "--maximum-fill") == 0) {
+            options.maximum_fill = true;
+        } else if (!has_value) {
+            return false;
+        } else if (std::strcmp(option, "--size") == 0) {
+            options.blocks = std::atoi(argv[++i]);
+        } else if (std::strcmp(option, "--players") == 0) {
+            options.players = std::atoi(argv[++i]);
+        } else if (std::strcmp(option, "--games") == 0) {
+            options.games = std::atoi(argv[++i]);
+        } else if (std::strcmp(option, "--seed") == 0) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(option, "--threads") == 0) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (std::strcmp(option, "--script") == 0) {
+            options.script = argv[++i];
+        } else if (std::strcmp(option, "--record") == 0) {
+            options.record = argv[++i];
+        } else if (std::strcmp(option, "--replay") == 0) {
+            options.replay = argv[++i];
+        } else {
+            return false;
+        }
+    }
+
+    return options.blocks >= 2 && options.blocks <= Board::max_board_size
+        && options.players == Board::initial_square_players && options.games >= 0;
+}
+
+static void print_scores(Game& game) {
+    const std::vector<float>& scores = game.get_final_scores();
+
+    std::cout.precision(1);
+    std::cout << "Scores:";
+
+    for (float score : scores) {
+        std::cout << " " << std::fixed << score;
+    }
+
+    std::cout << "\n";
+}
+
+// Plays a game where every player picks random placements until the game is
+// finished. Returns the number of placements made.
+static int play_random_game(Game& game, std::uint64_t seed) {
+    RandomPlayer player(seed);
+    Game::Placement placement;
+    int placements = 0;
+
+    while (!game.is_finished() && player.choose_placement(game, placement)) {
+        game.place(placement);
+        ++placements;
+    }
+
+    return placements;
+}
+
+// Plays the placements of a script. Returns false if the script can't be read
+// or has an invalid placement.
+static bool play_script(Game& game, std::istream& script) {
+    std::string line;
+    int line_number = 0;
+
+    while (std::getline(script, line)) {
+        ++line_number;
+
+        // Skip blank lines and comments
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        int x, y, shape;
+        if (std::sscanf(line.c_str(), "%d %d %d", &x, &y, &shape) != 3 || shape < 0
+            || shape >= shape_count || x < 0 || y < 0 || x >= game.get_board_size()
+            || y >= game.get_board_size()) {
+            std::cerr << "Line " << line_number << ": expected `x y shape`\n";
+            return false;
+        }
+
+        if (!game.place(Game::Placement{x, y, static_cast<shape_id>(shape)})) {
+            std::cerr << "Line " << line_number << ": invalid placement for player "
+                      << game.get_current_actor() << "\n";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Replays every game of a record without checking the rules. Returns false if
+// the record can't be read.
+static bool replay_games(const Options& options) {
+    std::ifstream in(options.replay, std::ios::binary);
+
+    if (!in) {
+        std::cerr << "Could not open " << options.replay << "\n";
+        return false;
+    }
+
+    GameReplayer replayer(in);
+    long long games = 0;
+    long long total_placements = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    while (replayer.next_game()) {
+        const int placements = replayer.replay_game();
+        total_placements += placements;
+        ++games;
+
+        if (!options.quiet) {
+            const GameRecordHeader& header = replayer.get_header();
+            std::cout << "Game " << header.seed << ": " << placements << " placements\n";
+        }
+    }
+
+    if (!replayer.is_valid()) {
+        std::cerr << options.replay << " is not a valid game record\n";
+        return false;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout.precision(3);
+    std::cout << games << " games with " << total_placements << " placements replayed in "
+              << elapsed.count() << " s\n";
+
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Options options;
+
+    if (!parse_options(argc, argv, options)) {
+        print_usage();
+        return EXIT_FAILURE;
+    }
+
+    if (!options.replay.empty()) {
+        return replay_games(options) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // Record the games if asked to
+    std::ofstream record_file;
+    std::unique_ptr<GameRecordWriter> writer;
+
+    if (!options.record.empty()) {
+        record_file.open(options.record, std::ios::binary);
+
+        if (!record_file) {
+            std::cerr << "Could not open " << options.record << "\n";
+            return EXIT_FAILURE;
+        }
+
+        writer = std::make_unique<GameRecordWriter>(record_file);
+    }
+
+    // Follow a script
+    if (!options.script.empty()) {
+        Game game(options.blocks, options.players, nullptr);
+        game.set_simulation_threads(options.threads);
+
+        if (options.maximum_fill) {
+            game.set_scoring_mode(Game::scoring_mode::maximum_fill);
+        }
+
+        if (writer) {
+            writer->begin_game(GameRecordHeader{options.blocks, options.players, 0});
+            game.set_record_writer(writer.get());
+        }
+
+        bool played = false;
+
+        if (options.script == "-") {
+            played = play_script(game, std::cin);
+        } else {
+            std::ifstream script(options.script);
+
+            if (!script) {
+                std::cerr << "Could not open " << options.script << "\n";
+                return EXIT_FAILURE;
+            }
+
+            played = play_script(game, script);
+        }
+
+        if (!played) {
+            return EXIT_FAILURE;
+        }
+
+        if (writer) {
+            writer->end_game();
+        }
+
+        std::cout << (game.is_finished() ? "Finished\n" : "Not finished\n");
+        print_scores(game);
+
+        return EXIT_SUCCESS;
+    }
+
+    // Play random games
+    long long total_placements = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < options.games; ++i) {
+        const std::uint64_t seed = options.seed + i;
+
+        Game game(options.blocks, options.players, nullptr);
+        game.set_simulation_threads(options.threads);
+
+        if (options.maximum_fill) {
+            game.set_scoring_mode(Game::scoring_mode::maximum_fill);
+        }
+
+        if (writer) {
+            writer->begin_game(GameRecordHeader{options.blocks, options.players, seed});
+            game.set_record_writer(writer.get());
+        }
+
+        const int placements = play_random_game(game, seed);
+        total_placements += placements;
+
+        if (writer) {
+            writer->end_game();
+        }
+
+        if (!options.quiet) {
+            std::cout << "Game " << seed << ": " << placements << " placements\n";
+            print_scores(game);
+        }
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout.precision(3);
+    std::cout << options.games << " games with " << total_placements << " placements in "
+              << elapsed.count() << " s\n";
+
+    return EXIT_SUCCESS;
+}
@@ -1,95 +1,317 @@
 #include <memory>
 #include <cmath>
+#include <bit>
+#include <cassert>
+#include <algorithm>
 
 #include <components/board.hpp>
 #include <components/piece.hpp>
-#include <components/square.hpp>
+#include <components/piece_registry.hpp>
 
-Board::Board() {
-    place_initial_squares();    
+Board::Board(int size, int players) {
+    assert(size >= 2 && size <= max_board_size);
+    assert(players >= 2);
+
+    size_ = size;
+    players_ = players;
+    plane_words_ = (size * size + 63) / 64;
+    lattice_size_ = 2 * size + 1;
+    lattice_words_ = (lattice_size_ * lattice_size_ + 63) / 64;
+
+    planes_.resize(plane_words_ * players_ * shape_count);
+    partner_placed_first_.resize(plane_words_);
+    lattices_.resize(lattice_words_ * players_);
+    generation_ = 0;
+
+    clear();
 }
 
 const Board::board_pointer Board::get_board() const {
-    return board_.begin();
+    return board_view(this);
 }
 
-bool Board::place_piece(std::shared_ptr<Piece> piece, int x, int y) {
+int Board::get_size() const {
+    return size_;
+}
 
-    bool success = false;
+int Board::get_players() const {
+    return players_;
+}
 
-    // Check if there is any space to place a piece
-    if (board_[y][x].first && board_[y][x].second) {
-        success = false;
-    } else {
-        // Try to place in the first slot first
-        if (!board_[y][x].first) {
-            board_[y][x].first = piece;
-        } else {
-            board_[y][x].second = piece;
+Board::board_slot Board::board_view::row_view::operator[](int x) const {
+    slot_contents slot = board_->get_slot(x, y_);
+
+    board_slot pieces;
+
+    if (slot.first) {
+        pieces.first = PieceRegistry::get_piece(slot.first.owner, slot.first.shape);
+    }
+
+    if (slot.second) {
+        pieces.second = PieceRegistry::get_piece(slot.second.owner, slot.second.shape);
+    }
+
+    return pieces;
+}
+
+Board::slot_contents Board::get_slot(int x, int y) const {
+    const int index = get_slot_index(x, y);
+    const int word = index / 64;
+    const bitboard bit = bitboard{1} << (index % 64);
+
+    slot_contents slot;
+
+    // Pieces are found in order of their shape, so the half with the smaller
+    // shape id is found first.
+    const bitboard* words = &planes_[get_plane_index(word, 0, 0)];
+
+    for (shape_id shape = 0; shape < shape_count; ++shape) {
+        for (int owner = 0; owner < players_; ++owner) {
+            if (words[owner * shape_count + shape] & bit) {
+                if (!slot.first) {
+                    slot.first = slot_piece{owner, shape};
+                } else {
+                    slot.second = slot_piece{owner, shape};
+                }
+            }
         }
+    }
 
-        success = true;
+    // Swap the halves back into the order they were placed
+    if (slot.second && (partner_placed_first_[word] & bit)) {
+        std::swap(slot.first, slot.second);
     }
 
-    return success;
+    return slot;
 }
 
-void Board::clear() {
+std::uint16_t Board::get_touching_points(int owner, int x, int y) const {
+    const std::uint64_t* owner_lattice = &lattices_[owner * lattice_words_];
+    std::uint16_t points = 0;
+
+    // Take three points from each of the three rows of the lattice through the slot
+    for (int row = 0; row < 3; ++row) {
+        const int index = (2 * y + row) * lattice_size_ + 2 * x;
+        const int word = index / 64;
+        const int offset = index % 64;
+
+        std::uint64_t bits = owner_lattice[word] >> offset;
 
-    // Reset all the smart pointers
-    for (auto rowIter = board_.begin(); rowIter != board_.end(); ++rowIter) {
-        for (auto colIter = rowIter->begin(); colIter != rowIter->end(); ++colIter) {
-            colIter->first.reset();
-            colIter->second.reset();
+        // The points can continue into the next word
+        if (offset > 61) {
+            bits |= owner_lattice[word + 1] << (64 - offset);
         }
+
+        points |= (bits & 0x7) << (row * 3);
+    }
+
+    return points;
+}
+
+bool Board::check_if_touching_owner(int owner, shape_id shape, int x, int y) const {
+    return (get_touching_points(owner, x, y) & get_shape_info(shape).point_mask) != 0;
+}
+
+bool Board::place_piece(std::shared_ptr<const Piece> piece, int x, int y) {
+    return place_piece(piece->get_owner_id(), piece->get_shape(), x, y);
+}
+
+bool Board::place_piece(int owner, shape_id shape, int x, int y) {
+    assert(owner >= 0 && owner < players_);
+
+    slot_contents slot = get_slot(x, y);
+
+    // Check if there is any space to place a piece
+    if (slot.second || (slot.first && slot.first.shape == square_shape)) {
+        return false;
+    }
+
+    // The second piece has to fill the rest of the slot
+    if (slot.first && get_shape_info(slot.first.shape).partner != shape) {
+        return false;
     }
 
+    const int index = get_slot_index(x, y);
+    const int word = index / 64;
+    const bitboard bit = bitboard{1} << (index % 64);
+
+    planes_[get_plane_index(word, owner, shape)] |= bit;
+    add_to_lattice(owner, shape, x, y);
+    key_ ^= get_piece_key(owner, shape, x, y);
+    ++generation_;
+
+    // Remember the order the halves were placed in
+    if (slot.first && slot.first.shape > shape) {
+        partner_placed_first_[word] |= bit;
+    }
+
+    return true;
+}
+
+bool Board::remove_piece(int owner, shape_id shape, int x, int y) {
+    if (!remove_from_planes(owner, shape, x, y)) {
+        return false;
+    }
+
+    remove_from_lattice(owner, shape, x, y);
+    return true;
+}
+
+bool Board::remove_piece(int owner, shape_id shape, int x, int y, std::uint16_t touching_before) {
+    if (!remove_from_planes(owner, shape, x, y)) {
+        return false;
+    }
+
+    const ShapeInfo& info = get_shape_info(shape);
+    std::uint64_t* owner_lattice = &lattices_[owner * lattice_words_];
+
+    // The points that were already there belong to other pieces
+    for (int i = 0; i < info.point_count; ++i) {
+        const Piece::Point point = info.points[i];
+
+        if (!(touching_before & (1 << ((1 - point.y) * 3 + point.x + 1)))) {
+            const int index = get_lattice_index(point, x, y);
+            owner_lattice[index / 64] &= ~(std::uint64_t{1} << (index % 64));
+        }
+    }
+
+    return true;
+}
+
+void Board::clear() {
+
+    // Clear all the bit planes
+    std::fill(planes_.begin(), planes_.end(), 0);
+    std::fill(partner_placed_first_.begin(), partner_placed_first_.end(), 0);
+    std::fill(lattices_.begin(), lattices_.end(), 0);
+    key_ = 0;
+    ++generation_;
+
     // Add the initial squares back
     place_initial_squares();
 }
 
-float Board::get_score(int id) const {
-    float score = 0;
-
-    for (auto rowIter = board_.begin(); rowIter != board_.end(); ++rowIter) {
-        for (auto colIter = rowIter->begin(); colIter != rowIter->end(); ++colIter) {
-           
-            if (colIter->first && colIter->first->get_owner_id() == id) {
-                if (colIter->first->get_piece_type() == Piece::piece_type::square) {
-                    score += 1.0f;
-                } else {
-                    score += 0.5f;
-                }
+std::uint64_t Board::get_key() const {
+    return key_;
+}
+
+std::uint64_t Board::get_generation() const {
+    return generation_;
+}
+
+std::uint64_t Board::compute_key() const {
+    std::uint64_t key = 0;
+
+    for (int y = 0; y < size_; ++y) {
+        for (int x = 0; x < size_; ++x) {
+            const slot_contents slot = get_slot(x, y);
+
+            if (slot.first) {
+                key ^= get_piece_key(slot.first.owner, slot.first.shape, x, y);
             }
-            
-            if (colIter->second && colIter->second->get_owner_id() == id) {
-                if (colIter->second->get_piece_type() == Piece::piece_type::square) {
-                    score += 1.0f;
-                } else {
-                    score += 0.5f;
-                }
+
+            if (slot.second) {
+                key ^= get_piece_key(slot.second.owner, slot.second.shape, x, y);
+            }
+        }
+    }
+
+    return key;
+}
+
+float Board::get_score(int id) const {
+    int squares = 0;
+    int halves = 0;
+
+    for (int word = 0; word < plane_words_; ++word) {
+        for (shape_id shape = 0; shape < shape_count; ++shape) {
+            const int pieces = std::popcount(planes_[get_plane_index(word, id, shape)]);
+
+            if (shape == square_shape) {
+                squares += pieces;
+            } else {
+                halves += pieces;
             }
         }
     }
 
     // The result should always without decimals
-    return score;
+    return squares + halves * 0.5f;
 }
 
 void Board::place_initial_squares() {
 
     const int player_one_id = 0;
     const int player_two_id = 1;
-    
+
     // Put squares in the corners for each player
-    board_[board_size - 1][0] = std::pair{
-                                std::make_unique<Square>(Square(player_one_id)),
-                                std::shared_ptr<Piece>()
-                                };
-    board_[0][board_size - 1] = std::pair{
-                                std::make_unique<Square>(Square(player_two_id)),
-                                std::shared_ptr<Piece>()
-                                };
+    place_piece(player_one_id, square_shape, 0, size_ - 1);
+    place_piece(player_two_id, square_shape, size_ - 1, 0);
+}
+
+void Board::add_to_lattice(int owner, shape_id shape, int x, int y) {
+    const ShapeInfo& info = get_shape_info(shape);
+    std::uint64_t* owner_lattice = &lattices_[owner * lattice_words_];
+
+    for (int i = 0; i < info.point_count; ++i) {
+        const int index = get_lattice_index(info.points[i], x, y);
+        owner_lattice[index / 64] |= std::uint64_t{1} << (index % 64);
+    }
+}
+
+void Board::remove_from_lattice(int owner, shape_id shape, int x, int y) {
+    const ShapeInfo& info = get_shape_info(shape);
+    std::uint64_t* owner_lattice = &lattices_[owner * lattice_words_];
+
+    for (int i = 0; i < info.point_count; ++i) {
+        const int index = get_lattice_index(info.points[i], x, y);
+
+        if (!check_if_point_of_owner(owner, index % lattice_size_, index / lattice_size_)) {
+            owner_lattice[index / 64] &= ~(std::uint64_t{1} << (index % 64));
+        }
+    }
+}
+
+bool Board::remove_from_planes(int owner, shape_id shape, int x, int y) {
+    assert(owner >= 0 && owner < players_);
+
+    const int index = get_slot_index(x, y);
+    const int word = index / 64;
+    const bitboard bit = bitboard{1} << (index % 64);
+
+    bitboard& plane = planes_[get_plane_index(word, owner, shape)];
+
+    if (!(plane & bit)) {
+        return false;
+    }
+
+    // At most one half is left, so the order they were placed in no longer matters
+    plane &= ~bit;
+    partner_placed_first_[word] &= ~bit;
+
+    key_ ^= get_piece_key(owner, shape, x, y);
+    ++generation_;
+
+    return true;
 }
 
+// A point is shared by up to four slots, which are the slots whose three
+// columns and three rows of the lattice both include it.
+bool Board::check_if_point_of_owner(int owner, int column, int row) const {
+    for (int y = std::max((row - 1) / 2, 0); y <= std::min(row / 2, size_ - 1); ++y) {
+        for (int x = std::max((column - 1) / 2, 0); x <= std::min(column / 2, size_ - 1); ++x) {
+            const int index = get_slot_index(x, y);
+            const bitboard bit = bitboard{1} << (index % 64);
+            const std::uint16_t point = 1 << ((row - 2 * y) * 3 + column - 2 * x);
 
+            for (shape_id shape = 0; shape < shape_count; ++shape) {
+                if ((planes_[get_plane_index(index / 64, owner, shape)] & bit)
+                    && (get_shape_info(shape).point_mask & point)) {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
@@ -1,57 +1,34 @@
 #include "components/piece.hpp"
+#include "components/shapes.hpp"
 
-Piece::Piece(int owner_id) {
+Piece::Piece(int owner_id, shape_id shape) {
     owner_id_ = owner_id;
+    shape_ = shape;
 }
 
 std::vector<Piece::Point> Piece::get_points() const {
-    return points_; 
+    const ShapeInfo& info = get_shape_info(shape_);
+    return std::vector<Point>(info.points.begin(), info.points.begin() + info.point_count);
 }
 
 Piece::piece_type Piece::get_piece_type() const {
-    return piece_type_;
+    return get_shape_info(shape_).type;
+}
+
+shape_id Piece::get_shape() const {
+    return shape_;
 }
 
 int Piece::get_owner_id() const {
     return owner_id_;
 }
 
+// The rotated shapes are precomputed, so rotating only changes the shape id.
+// Squares stay the same when rotated by 90 degrees, so they rotate into themselves.
 void Piece::rotate(rotation rot) {
-    // Update the piece's current rotation.
     if (rot == Piece::rotation::clockwise) {
-        rotation_ += 90;
-        // Keep rotation within [0,360) degrees.
-        if (rotation_ == 360) {
-            rotation_ = 0;
-        }
+        shape_ = get_shape_info(shape_).clockwise;
     } else {
-        // Change 0 to 360 to keep rotation in positive degrees.
-        if (rotation_ == 0) {
-            rotation_ = 360;
-        }
-        rotation_ -= 90;
-    }
-
-    // Squares stay the same when rotated by 90 degrees, so it's simpler
-    // to not change the order of the points by not rotating at all.
-    if (piece_type_ != Piece::piece_type::square) {
-        // Update the points based on the rotation.
-        if (rot == Piece::rotation::clockwise) {
-            // For clockwise, replace (x,y) with (y,-x).
-            for (Piece::Point& point : points_) {
-                int x = point.x;
-                int y = point.y;
-                point.x = y;
-                point.y = -x;
-            }
-        } else {
-            // For counterclockwise, replace (x,y) with (-y,x).
-            for (Piece::Point& point : points_) {
-                int x = point.x;
-                int y = point.y;
-                point.x = -y;
-                point.y = x;
-            }
-        }
+        shape_ = get_shape_info(shape_).counterclockwise;
     }
 }
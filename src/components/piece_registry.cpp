@@ -0,0 +1,46 @@
+#include <array>
+#include <cassert>
+#include <mutex>
+#include <vector>
+
+#include "components/piece_registry.hpp"
+#include "components/rectangle.hpp"
+#include "components/shapes.hpp"
+#include "components/square.hpp"
+#include "components/triangle.hpp"
+
+std::shared_ptr<const Piece> PieceRegistry::get_piece(int owner, shape_id shape) {
+    assert(owner >= 0);
+    assert(shape < shape_count);
+
+    using owner_pieces = std::array<std::shared_ptr<const Piece>, shape_count>;
+
+    static std::mutex mutex;
+    static std::vector<owner_pieces> pieces;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Make the pieces of every owner up to this one
+    while (static_cast<int>(pieces.size()) <= owner) {
+        const int new_owner = pieces.size();
+        owner_pieces& new_pieces = pieces.emplace_back();
+
+        for (int i = 0; i < shape_count; ++i) {
+            switch (get_shape_info(i).type) {
+                case Piece::piece_type::triangle:
+                    new_pieces[i] = std::make_shared<const Triangle>(new_owner, i);
+                    break;
+
+                case Piece::piece_type::rectangle:
+                    new_pieces[i] = std::make_shared<const Rectangle>(new_owner, i);
+                    break;
+
+                default:
+                    new_pieces[i] = std::make_shared<const Square>(new_owner);
+                    break;
+            }
+        }
+    }
+
+    return pieces[owner][shape];
+}
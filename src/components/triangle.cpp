@@ -2,19 +2,17 @@
 #include <cassert>
 
 #include "components/piece.hpp"
+#include "components/shapes.hpp"
 #include "components/triangle.hpp"
 
 
 // The triangles takes up half a square.
 // The origin (0,0) of the space is considered to be at the center of 
 // a square. The points are in clockwise order starting from the bottom right.
-Triangle::Triangle(int owner_id) : Piece(owner_id) {
-    points_.push_back(Point{-1, -1});
-    points_.push_back(Point{-1, 1});
-    points_.push_back(Point{1, 1});
-    rotation_ = 0;
-    piece_type_ = piece_type::triangle;
+Triangle::Triangle(int owner_id) : Piece(owner_id, triangle_shape) {}
 
+Triangle::Triangle(int owner_id, shape_id shape) : Piece(owner_id, shape) {
+    assert(get_piece_type() == piece_type::triangle);
 }
 
 Triangle::~Triangle() {};
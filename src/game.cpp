@@ -1,49 +1,77 @@
 #include <cassert>
-#include <set>
-#include <thread>
-#include <chrono>
+#include <algorithm>
+#include <bit>
 #include <iostream>
 
 #include "game.hpp"
 #include "actors/player.hpp"
 #include "components/piece.hpp"
-#include "components/triangle.hpp"
-#include "components/square.hpp"
-#include "components/rectangle.hpp"
+#include "components/piece_registry.hpp"
+#include "components/shapes.hpp"
 #include "input/actions.hpp"
+#include "record/game_record.hpp"
+#include "search/fill_solver.hpp"
 
-// The number of blocks should be used to determine the board size,
-// but this is left unimplemented due to original time constraints.
-Game::Game(int blocks, int players, InputHandler* input_handler) {
-    blocks_ = blocks;
+// Memory for each actor's table of positions when searching for maximum fills.
+// Searches stop as soon as they match their bound, which is almost always the
+// first fill, so the tables stay small.
+static constexpr std::size_t fill_solver_table_megabytes = 1;
+
+// The number of blocks is used as the size of the board.
+Game::Game(int blocks, int players, InputHandler* input_handler)
+    : board_(blocks, players), final_board_(blocks, players) {
     num_actors_ = players;
     input_handler_ = input_handler;
+    record_writer_ = nullptr;
+    scoring_mode_ = scoring_mode::greedy_fill;
 
     // Set starting turn
     current_actor_turn_ = 0;
     half_squares_placed_ = 0;
 
+    // Nothing has been checked yet
+    is_end_state_outdated_ = true;
+    is_finished_ = false;
+    final_scores_.resize(players);
+    reachable_regions_.resize(players);
+    simulated_boards_.assign(players, board_);
+    fill_frontiers_.assign(players,
+        std::vector<Board::bitboard>((blocks * blocks + 63) / 64));
+
     reset_cursor(current_actor_turn_);
 
     // Create players
     for (int i = 0; i < players; ++i) {
-        players_.push_back(Player(i, input_handler_));
+        actors_.push_back(std::make_unique<Player>(i, input_handler_));
     }
 }
 
-void Game::progress_turn() {
-    Player current_player = players_[current_actor_turn_];
+Game::~Game() = default;
+
+Action Game::progress_turn() {
+    Actor& current_actor = *actors_[current_actor_turn_];
 
-    Action player_action = current_player.do_action();
+    Action player_action = current_actor.do_action(*this);
 
-    // Get mouse location and use it to calculate the cursor position.
-    board_pos pos = find_board_location_of_mouse();
+    shape_id target_shape;
 
-    // Set cursor position based on board location of mouse.
-    current_cursor_.x = pos.i;
-    current_cursor_.y = pos.j;
+    if (current_actor.get_cursor(current_cursor_.x, current_cursor_.y, target_shape)) {
 
-    const int board_pos_max = board_.board_size - 1;
+        // The actor chose its own placement, so point the cursor at it
+        if (current_cursor_.piece->get_shape() != target_shape) {
+            current_cursor_.piece = PieceRegistry::get_piece(current_actor_turn_, target_shape);
+        }
+    } else {
+
+        // Get mouse location and use it to calculate the cursor position.
+        board_pos pos = find_board_location_of_mouse();
+
+        // Set cursor position based on board location of mouse.
+        current_cursor_.x = pos.i;
+        current_cursor_.y = pos.j;
+    }
+
+    const int board_pos_max = board_.get_size() - 1;
 
     if (current_cursor_.x < 0) {
         current_cursor_.x = 0;
@@ -60,13 +88,13 @@ void Game::progress_turn() {
     // Apply action's effect
     switch (player_action) {
         case Action::NONE:
-            return; // Try to avoid sleeping to act faster after sleep.
+            break;
         case Action::ROTATE_CLOCKWISE: 
-            current_cursor_.piece->rotate();
+            rotate_cursor_piece(Piece::rotation::clockwise);
             break;
 
         case Action::ROTATE_COUNTERCLOCKWISE: 
-            current_cursor_.piece->rotate(Piece::rotation::counterclockwise);
+            rotate_cursor_piece(Piece::rotation::counterclockwise);
             break;
 
         case Action::TOGGLE: 
@@ -74,53 +102,110 @@ void Game::progress_turn() {
             break;
 
         case Action::PLACE:
-            if (check_if_valid_placement(current_cursor_.piece, current_cursor_.x,
-                current_cursor_.y, half_squares_placed_, board_)) {
+            place(Placement{current_cursor_.x, current_cursor_.y,
+                current_cursor_.piece->get_shape()});
+            break;
+    }
 
-                board_.place_piece(current_cursor_.piece, current_cursor_.x, current_cursor_.y);
+    return player_action;
+}
 
-                // Update the number of half squares placed by the actor
-                if (current_cursor_.piece->get_piece_type() == Piece::piece_type::square) {
-                    half_squares_placed_ = 2;
-                } else {
-                    ++half_squares_placed_;
-                }
-                    
-                if (half_squares_placed_ == 2) {
-                    half_squares_placed_ = 0;
-                    current_actor_turn_ = get_next_actor();
-                }
-                
-                // Reset after any potential changes to the actor id
-                reset_cursor(current_actor_turn_);
-                
-                // Add additional sleep to prevent double placing
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            }
-            break;
+void Game::set_actor(int id, std::unique_ptr<Actor> actor) {
+    assert(id >= 0 && id < num_actors_);
+    actors_[id] = std::move(actor);
+}
+
+bool Game::place(const Placement& placement) {
+    if (!check_if_valid_placement(current_actor_turn_, placement.shape, placement.x,
+        placement.y, half_squares_placed_, board_)) {
+        return false;
+    }
+
+    apply_placement(placement);
+    undo_stack_.clear();
+
+    if (record_writer_) {
+        record_writer_->add_placement(placement);
     }
 
-    // Sleep to give the player time to react to the piece movements
-    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    // Reset after any potential changes to the actor id
+    reset_cursor(current_actor_turn_);
+
+    return true;
 }
 
-bool Game::check_if_valid_placement(std::shared_ptr<Piece> piece, int x, int y,
+bool Game::make_move(const Placement& placement) {
+    if (!check_if_valid_placement(current_actor_turn_, placement.shape, placement.x,
+        placement.y, half_squares_placed_, board_)) {
+        return false;
+    }
+
+    undo_stack_.push_back(Undo{placement, static_cast<std::uint8_t>(current_actor_turn_),
+        static_cast<std::uint8_t>(half_squares_placed_),
+        board_.get_touching_points(current_actor_turn_, placement.x, placement.y)});
+    apply_placement(placement);
+
+    return true;
+}
+
+void Game::unmake_move() {
+    assert(!undo_stack_.empty());
+
+    const Undo& undo = undo_stack_.back();
+    board_.remove_piece(undo.actor, undo.placement.shape, undo.placement.x, undo.placement.y,
+        undo.touching);
+    current_actor_turn_ = undo.actor;
+    half_squares_placed_ = undo.half_squares_placed;
+    is_end_state_outdated_ = true;
+
+    undo_stack_.pop_back();
+}
+
+int Game::get_move_count() const {
+    return undo_stack_.size();
+}
+
+void Game::apply_placement(const Placement& placement) {
+    board_.place_piece(current_actor_turn_, placement.shape, placement.x, placement.y);
+    is_end_state_outdated_ = true;
+
+    // Update the number of half squares placed by the actor
+    if (placement.shape == square_shape) {
+        half_squares_placed_ = 2;
+    } else {
+        ++half_squares_placed_;
+    }
+
+    if (half_squares_placed_ == 2) {
+        half_squares_placed_ = 0;
+        current_actor_turn_ = get_next_actor();
+    }
+}
+
+bool Game::check_if_valid_placement(std::shared_ptr<const Piece> piece, int x, int y,
     int half_squares_placed, const Board& target_board)
     const {
-    bool is_enough_half_squares_left = check_if_sufficient_half_squares_left(piece,
+    return check_if_valid_placement(piece->get_owner_id(), piece->get_shape(), x, y,
+        half_squares_placed, target_board);
+}
+
+bool Game::check_if_valid_placement(int owner, shape_id shape, int x, int y,
+    int half_squares_placed, const Board& target_board)
+    const {
+    bool is_enough_half_squares_left = check_if_sufficient_half_squares_left(shape,
         half_squares_placed);
 
     if (!is_enough_half_squares_left) {
         return false;
     }
 
-    bool is_space_in_slot = check_if_space_in_board_slot(piece, x, y, target_board);
+    bool is_space_in_slot = check_if_space_in_board_slot(shape, x, y, target_board);
 
     if (!is_space_in_slot) {
         return false;
     }
 
-    bool is_connected = check_if_connected_to_existing_pieces(piece, x, y, target_board);
+    bool is_connected = check_if_connected_to_existing_pieces(owner, shape, x, y, target_board);
 
     if (!is_connected) {
         return false;
@@ -129,18 +214,17 @@ bool Game::check_if_valid_placement(std::shared_ptr<Piece> piece, int x, int y,
     return true;
 }
 
-bool Game::check_if_sufficient_half_squares_left(std::shared_ptr<Piece> piece, int half_squares_placed) const {
-    if (half_squares_placed == 1 && piece->get_piece_type() == Piece::piece_type::square) {
+bool Game::check_if_sufficient_half_squares_left(shape_id shape, int half_squares_placed) {
+    if (half_squares_placed == 1 && shape == square_shape) {
         return false;
     }
     
     return true;
 }
 
-bool Game::check_if_space_in_board_slot(std::shared_ptr<Piece> piece, int x, int y,
+bool Game::check_if_space_in_board_slot(shape_id shape, int x, int y,
     const Board& target_board) const {
-    const Board::board_pointer board = target_board.get_board();
-    Board::board_slot slot = board[y][x]; // Switch these since board is 2d array
+    const Board::slot_contents slot = target_board.get_slot(x, y);
 
     // Space in both slots
     if (!slot.first && !slot.second) {
@@ -149,22 +233,12 @@ bool Game::check_if_space_in_board_slot(std::shared_ptr<Piece> piece, int x, int
     // Space in the second slot
     } else if (slot.first && !slot.second) {
         // A square can be the only thing in a slot
-        if (piece->get_piece_type() != Piece::piece_type::square 
-            || slot.first->get_piece_type() != Piece::piece_type::square) {
-            
-            // Both pieces in a slot need to match type
-            if (slot.first->get_piece_type() == piece->get_piece_type()) {
-                
-                // The first piece and second piece need to be different by a rotation of 180 degrees
-                std::shared_ptr<Piece> piece_copy = piece->clone();
-
-                // Rotate 180
-                piece_copy->rotate();
-                piece_copy->rotate();
-
-                if (*slot.first.get() == *piece_copy.get()) {
-                    return true;
-                }
+        if (slot.first.shape != square_shape) {
+
+            // The first piece and second piece need to be the same type and different
+            // by a rotation of 180 degrees
+            if (get_shape_info(slot.first.shape).partner == shape) {
+                return true;
             }
         }
     }
@@ -172,134 +246,173 @@ bool Game::check_if_space_in_board_slot(std::shared_ptr<Piece> piece, int x, int
     return false;
 }
 
-// Shifts the piece's points by `x` and `y` based on the origin being in the upper left corner 
-// of the board.
-void shift_points_inplace(std::vector<Piece::Point>& points, int x, int y) {
+// The board keeps track of the points of each player's pieces, so a piece is connected
+// when any of its points is already one of them.
+bool Game::check_if_connected_to_existing_pieces(int owner, shape_id shape, int x, int y,
+    const Board& target_board) const {
+    return target_board.check_if_touching_owner(owner, shape, x, y);
+}
 
-    // Each board square has a width and height of 2, so the shifts need to be 
-    // in multiplies of 2 to not overlap pieces.
-    Piece::Point x_y_shift = {x * 2, y * -2};
+int Game::get_max_placements(int blocks) {
+    return blocks * blocks * shape_count;
+}
 
-    for (Piece::Point& p : points) {
-        p += x_y_shift;
-    }
+int Game::generate_placements(int owner, int half_squares_placed, const Board& target_board,
+    std::span<Placement> placements) {
+    std::size_t count = 0;
+
+    visit_valid_placements(owner, half_squares_placed, target_board,
+        [&placements, &count](const Placement& placement) {
+            if (count == placements.size()) {
+                return false;
+            }
+
+            placements[count++] = placement;
+            return true;
+        });
+
+    return static_cast<int>(count);
 }
 
-bool Game::check_if_connected_to_existing_pieces(std::shared_ptr<Piece> piece, int x, int y,
-    const Board& target_board) const {
-    
-    const Board::board_pointer board = target_board.get_board();
-    std::vector<Piece::Point> piece_points = piece->get_points();
-    const int piece_owner_id = piece->get_owner_id();
-
-    // Shift piece's coordinates over based on x and y
-    shift_points_inplace(piece_points, x, y);
-
-    // Get area to check in
-    int x_start = x - 1;
-    int y_start = y - 1;
-    int x_end = x + 2; // Add two to be one past the slot to check
-    int y_end = y + 2;
-
-    // Enforce bounds of board
-    if (x_start < 0) {
-        x_start = 0;
-    }
+int Game::generate_placements(int owner, int half_squares_placed, const Board& target_board,
+    std::vector<Placement>& placements) {
+    int count = generate_placements(owner, half_squares_placed, target_board,
+        std::span<Placement>(placements));
 
-    if (x_end > Board::board_size) {
-        x_end = Board::board_size;
-    }
-    
-    if (y_start < 0) {
-        y_start = 0;
-    }
+    // A full buffer could be missing placements
+    if (count == static_cast<int>(placements.size())) {
+        const int needed = count_placements(owner, half_squares_placed, target_board);
 
-    if (y_end > Board::board_size) {
-        y_end = Board::board_size;
+        if (needed > count) {
+            placements.resize(2 * needed);
+            count = generate_placements(owner, half_squares_placed, target_board,
+                std::span<Placement>(placements));
+        }
     }
 
-    // Loop through all the pieces in the given area
-    for (int i = x_start; i < x_end; ++i) {
-        for (int j = y_start; j < y_end; ++j) {
-            Board::board_slot slot = board[j][i];
-       
-            if (slot.first && slot.first->get_owner_id() == piece_owner_id) {
-                // Need to offset the pieces based on their location
-                std::vector<Piece::Point> points = slot.first->get_points();
-                shift_points_inplace(points, i, j);
-                
-                if (compare_points(points, piece_points)) {
-                    return true;
+    return count;
+}
+
+int Game::count_placements(int owner, int half_squares_placed, const Board& target_board) {
+    int count = 0;
+
+    visit_valid_placements(owner, half_squares_placed, target_board,
+        [&count](const Placement&) {
+            ++count;
+            return true;
+        });
+
+    return count;
+}
+
+// Gives the same placements as trying `check_if_valid_placement` with every shape
+// in every slot, but only reads each slot once and skips slots that the owner
+// isn't touching before looking at what is in them.
+template <typename Visitor>
+void Game::visit_valid_placements(int owner, int half_squares_placed,
+    const Board& target_board, Visitor&& visit) {
+    const int size = target_board.get_size();
+
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            const std::uint16_t touching = target_board.get_touching_points(owner, x, y);
+
+            if (!touching) {
+                continue;
+            }
+
+            const Board::slot_contents slot = target_board.get_slot(x, y);
+
+            // No space left in the slot
+            if (slot.second || (slot.first && slot.first.shape == square_shape)) {
+                continue;
+            }
+
+            // Only the partner of the first half fits in the rest of the slot
+            if (slot.first) {
+                const shape_id partner = get_shape_info(slot.first.shape).partner;
+
+                if ((get_shape_info(partner).point_mask & touching)
+                    && !visit(Placement{x, y, partner})) {
+                    return;
                 }
+
+                continue;
             }
-            
-            if (slot.second && slot.second->get_owner_id() == piece_owner_id) {
-                std::vector<Piece::Point> points = slot.second->get_points();
-                shift_points_inplace(points, i, j);
-                
-                if (compare_points(points, piece_points)) {
-                    return true;
+
+            for (shape_id shape = 0; shape < shape_count; ++shape) {
+                if (!check_if_sufficient_half_squares_left(shape, half_squares_placed)) {
+                    continue;
+                }
+
+                if ((get_shape_info(shape).point_mask & touching)
+                    && !visit(Placement{x, y, shape})) {
+                    return;
                 }
             }
         }
     }
-
-
-    return false;
 }
 
-// Checks if any of the points in one vector match the other
-bool Game::compare_points(std::vector<Piece::Point> points1, std::vector<Piece::Point> points2) const {
-    for (auto& p1 : points1) {
-        for (auto& p2 : points2) {
-            if (p1 == p2) {
-                return true;
+bool Game::check_if_game_is_finished(Board& final_board) {
+    // Every slot an actor can reach is filled when simulating their placements, so
+    // actors that can reach the same slot would overlap. Finding that out only
+    // takes a pass over the board, which settles most checks before the game ends.
+    for (int i = 0; i < num_actors_; ++i) {
+        reachable_regions_[i].compute(board_, i);
+
+        for (int j = 0; j < i; ++j) {
+            if (reachable_regions_[i].intersects(reachable_regions_[j])) {
+                return false;
             }
         }
     }
 
-    return false;
-}
-
-bool Game::check_if_game_is_finished(Board& final_board) {
-    // Create a board for each actor based on the current board
-    std::vector<Board> boards;
+    // Reset the board for each actor to the current board
+    std::vector<Board>& boards = simulated_boards_;
 
     for (int i = 0; i < num_actors_; ++i) {
-        Board new_board = board_;
-        boards.push_back(new_board);
+        boards[i] = board_;
     }
 
     // Treat it as if the actor is the only actor and places until the board is full
-    for (int i = 0; i < num_actors_; ++i) {
-        simulate_filling_placements(boards[i], i);
+    // Each actor only changes their own board, so they can be simulated in parallel
+    auto fill = [this, &boards](int i) {
+        if (scoring_mode_ == scoring_mode::maximum_fill) {
+            fill_solvers_[i]->solve(boards[i], i);
+        } else {
+            simulate_filling_placements(boards[i], i);
+        }
+    };
+
+    if (simulation_pool_) {
+        simulation_pool_->run(num_actors_, fill);
+    } else {
+        for (int i = 0; i < num_actors_; ++i) {
+            fill(i);
+        }
     }
     
     // Add these pieces to a new board and check for overlap.
     // If there is overlap it means that the game can't be done since actors can 
     // place in the same spot.
 
-    Board::board_pointer final_board_arr = final_board.get_board();
+    const int size = board_.get_size();
 
     for (Board& board : boards) {
-        Board::board_pointer board_arr = board.get_board();
-        for (int i = 0; i < Board::board_size; ++i) {
-            for (int j = 0; j < Board::board_size; ++j) {
+        for (int i = 0; i < size; ++i) {
+            for (int j = 0; j < size; ++j) {
                  
-                Board::board_slot slot = board_arr[i][j];
-                Board::board_slot final_slot = final_board_arr[i][j];
+                const Board::slot_contents slot = board.get_slot(j, i);
+                const Board::slot_contents final_slot = final_board.get_slot(j, i);
 
                 // Check if we have anything to place
                 if (slot.first) {
                
                     // Full slot
                     // Check for a single square that matches
-                    if (final_slot.first && 
-                        final_slot.first->get_piece_type() == Piece::piece_type::square) {
-                        
-                        bool first_slot_same = *slot.first.get() == *final_slot.first.get()
-                            && slot.first->get_owner_id() == final_slot.first->get_owner_id();
-                        if (!first_slot_same) {
+                    if (final_slot.first && final_slot.first.shape == square_shape) {
+                        if (slot.first != final_slot.first) {
                             return false;
                         }
 
@@ -309,11 +422,11 @@ bool Game::check_if_game_is_finished(Board& final_board) {
                     // Empty slots
                     if (!final_slot.first) {
                         // We can use slot.first here since we must have something to place
-                        final_board.place_piece(slot.first, j, i);
+                        final_board.place_piece(slot.first.owner, slot.first.shape, j, i);
 
                         // Check if we have a second piece to place
                         if (slot.second) {
-                            final_board.place_piece(slot.second, j, i);
+                            final_board.place_piece(slot.second.owner, slot.second.shape, j, i);
                         }
 
                         continue;
@@ -323,19 +436,11 @@ bool Game::check_if_game_is_finished(Board& final_board) {
                     // Must have the same pieces in slot
                     // otherwise it's an overlap
                     if (final_slot.first && final_slot.second) {
-                        bool first_slot_same = *slot.first.get() == *final_slot.first.get()
-                            && slot.first->get_owner_id() == final_slot.first->get_owner_id();
-                        if (!first_slot_same) {
+                        if (slot.first != final_slot.first) {
                             return false;
                         } else {
-                            if (slot.second) {
-                                bool second_slot_same = *slot.second.get() ==
-                                    *final_slot.second.get()
-                                    && slot.second->get_owner_id() ==
-                                    final_slot.second->get_owner_id();
-                                if (!second_slot_same) {
-                                    return false;
-                                }
+                            if (slot.second && slot.second != final_slot.second) {
+                                return false;
                             }
                             continue;
                         }
@@ -343,15 +448,10 @@ bool Game::check_if_game_is_finished(Board& final_board) {
 
                     // Partially filled slot
                     // Check first slot match since we know there must be something there
-                    if (!final_slot.first) {
-                    }
-
-                    bool first_slot_same = *slot.first.get() == *final_slot.first.get()
-                            && slot.first->get_owner_id() == final_slot.first->get_owner_id();
-                    if (first_slot_same) {
+                    if (slot.first == final_slot.first) {
                         // If the first slot is the same, then the second piece must fit
                         if (slot.second) {
-                            final_board.place_piece(slot.second, j, i);
+                            final_board.place_piece(slot.second.owner, slot.second.shape, j, i);
                         }
                     } else {
                         return false;
@@ -364,145 +464,162 @@ bool Game::check_if_game_is_finished(Board& final_board) {
     return true;
 }
 
-bool Game::fill_slot(Board& board, const Board::board_slot& slot, int id, int i, int j) {
+bool Game::is_finished() {
+    update_end_state();
+    return is_finished_;
+}
 
-    // Check if there is space in the slot
-    if (!slot.first || !slot.second) {
+const Board& Game::get_final_board() {
+    update_end_state();
+    return final_board_;
+}
 
-        // Try to place each type of piece in the slot
-        // Start with a square since that fills an empty slot the fastest
-        // And also ensures we only have to place one piece if there is space
-        std::shared_ptr<Piece> piece = std::make_shared<Square>(id);
+const std::vector<float>& Game::get_final_scores() {
+    update_end_state();
+    return final_scores_;
+}
 
-        // Square
-        if (check_if_valid_placement(piece, j, i, 0, board)) {
-            board.place_piece(piece, j, i);
-            return true;
-        }
+void Game::update_end_state() {
+    if (!is_end_state_outdated_) {
+        return;
+    }
 
-        // Triangles
-        piece = std::make_shared<Triangle>(id);
-        for (int rotations = 0; rotations < 4; ++rotations) {
-            if (check_if_valid_placement(piece, j, i, 0, board)) {
-                board.place_piece(piece, j, i);
-                return true;
-            }
-            piece->rotate();
+    final_board_.clear();
+    is_finished_ = check_if_game_is_finished(final_board_);
+
+    for (int i = 0; i < num_actors_; ++i) {
+        final_scores_[i] = final_board_.get_score(i);
+    }
+
+    is_end_state_outdated_ = false;
+}
+
+bool Game::fill_slot(Board& board, int id, int x, int y) {
+    const std::uint16_t touching = board.get_touching_points(id, x, y);
+
+    if (!touching) {
+        return false;
+    }
+
+    const Board::slot_contents slot = board.get_slot(x, y);
+
+    // Only the partner of the first half fits in the rest of the slot
+    if (slot.first) {
+        const shape_id partner = get_shape_info(slot.first.shape).partner;
+
+        if (slot.first.shape == square_shape || slot.second
+            || !(get_shape_info(partner).point_mask & touching)) {
+            return false;
         }
 
-        // Rectangles
-        piece = std::make_shared<Rectangle>(id);
-        for (int rotations = 0; rotations < 4; ++rotations) {
-            if (check_if_valid_placement(piece, j, i, 0, board)) {
-                board.place_piece(piece, j, i);
-                return true;
-            }
-            piece->rotate();
+        return board.place_piece(id, partner, x, y);
+    }
+
+    // Try to place each shape in the slot
+    // Start with a square since that fills an empty slot the fastest
+    // And also ensures we only have to place one piece if there is space
+    // Then try each rotation of the triangles, followed by the rectangles
+    for (shape_id shape = 0; shape < shape_count; ++shape) {
+        if (get_shape_info(shape).point_mask & touching) {
+            return board.place_piece(id, shape, x, y);
         }
     }
 
     return false;
 }
 
+// Fills the same slots as trying every shape in order in the lowest slot next to
+// a newly filled slot, over and over, but keeps the slots left to try as bits so
+// nothing is allocated and each slot is only waiting to be tried once.
 void Game::simulate_filling_placements(Board& board, int id) {
-   
-    // Create queue of where we can possibly place
-    std::set<board_pos> potential_positions;
-
-    // Get possible placement positions using current board locations
-    for (int i = 0; i < Board::board_size; ++i) {
-        for (int j = 0; j < Board::board_size; ++j) {
-            Board::board_slot slot = board_.get_board()[i][j];
-            
-            // Get area to check within
-            int i_start = i - 1;
-            int j_start = j - 1;
-            int i_end = i + 2; // Add two to be one past the slot to check
-            int j_end = j + 2;
-
-            // Enforce bounds of board
-            if (i_start < 0) {
-                i_start = 0;
+    assert(id >= 0 && id < num_actors_);
+    assert(board.get_size() == board_.get_size());
+
+    const int size = board.get_size();
+    std::vector<Board::bitboard>& frontier = fill_frontiers_[id];
+    std::fill(frontier.begin(), frontier.end(), 0);
+
+    // Slots that can be filled, which are next to the slots that are filled
+    auto add_neighbours = [&frontier, &board, size](int x, int y) {
+        for (int h = std::max(y - 1, 0); h < std::min(y + 2, size); ++h) {
+            for (int w = std::max(x - 1, 0); w < std::min(x + 2, size); ++w) {
+                const Board::slot_contents slot = board.get_slot(w, h);
+
+                if (!slot.second && !(slot.first && slot.first.shape == square_shape)) {
+                    const int index = h * size + w;
+                    frontier[index / 64] |= Board::bitboard{1} << (index % 64);
+                }
             }
+        }
+    };
 
-            if (i_end > Board::board_size) {
-                i_end = Board::board_size;
-            }
-            
-            if (j_start < 0) {
-                j_start = 0;
-            }
+    // Start next to the actor's pieces
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            const Board::slot_contents slot = board.get_slot(x, y);
 
-            if (j_end > Board::board_size) {
-                j_end = Board::board_size;
-            }
-            
-            bool first = slot.first && slot.first->get_owner_id() == id;
-            bool second = slot.second && slot.second->get_owner_id() == id;
-            // Add potential positions around a piece
-            if (first || second) {
-                for (int h = i_start; h < i_end; ++h) {
-                    for (int w = j_start; w < j_end; ++w) {
-                        board_pos new_pos = {h, w};
-                        potential_positions.insert(new_pos);
-                    }
-                }
+            if ((slot.first && slot.first.owner == id) || (slot.second && slot.second.owner == id)) {
+                add_neighbours(x, y);
             }
         }
     }
 
-    // Go through all positions
-    while (!potential_positions.empty()) {
-        board_pos pos = potential_positions.extract(potential_positions.begin()).value();
+    // Always try the lowest slot left, which can be before the last slot tried
+    int word = 0;
+    const int words = frontier.size();
 
-        bool filled_slot = fill_slot(board, board_.get_board()[pos.i][pos.j], id, pos.i, pos.j);
+    while (word < words) {
+        if (!frontier[word]) {
+            ++word;
+            continue;
+        }
 
-        // Add all nearby positions
-        if (filled_slot) {
+        const int index = word * 64 + std::countr_zero(frontier[word]);
+        frontier[word] &= frontier[word] - 1;
 
-            const int i = pos.i;
-            const int j = pos.j;
+        const int x = index % size;
+        const int y = index / size;
 
-            // Get area to check within
-            int i_start = i - 1;
-            int j_start = j - 1;
-            int i_end = i + 2; // Add two to be one past the slot to check
-            int j_end = j + 2;
+        if (!fill_slot(board, id, x, y)) {
+            continue;
+        }
 
-            // Enforce bounds of board
-            if (i_start < 0) {
-                i_start = 0;
-            }
+        add_neighbours(x, y);
+        word = std::min(word, std::max(index - size - 1, 0) / 64);
+    }
+}
 
-            if (i_end > Board::board_size) {
-                i_end = Board::board_size;
-            }
-            
-            if (j_start < 0) {
-                j_start = 0;
-            }
+void Game::set_simulation_threads(int threads) {
+    // The calling thread also runs simulations, so it's one less worker
+    if (threads > 1) {
+        simulation_pool_ = std::make_unique<ThreadPool>(threads - 1);
+    } else {
+        simulation_pool_.reset();
+    }
+}
 
-            if (j_end > Board::board_size) {
-                j_end = Board::board_size;
-            }
-            
-            // Add potential positions around a piece
-            for (int h = i_start; h < i_end; ++h) {
-                for (int w = j_start; w < j_end; ++w) {
-                    board_pos new_pos = {h, w};
-                    potential_positions.insert(new_pos);
-                }
-            }
+void Game::set_scoring_mode(scoring_mode mode) {
+    scoring_mode_ = mode;
+
+    // Each actor gets their own solver so they can be solved in parallel
+    if (mode == scoring_mode::maximum_fill && fill_solvers_.empty()) {
+        for (int i = 0; i < num_actors_; ++i) {
+            fill_solvers_.push_back(std::make_unique<FillSolver>(fill_solver_table_megabytes));
         }
     }
 
+    is_end_state_outdated_ = true;
+}
+
+void Game::set_record_writer(GameRecordWriter* record_writer) {
+    record_writer_ = record_writer;
 }
 
 // Not resetting the position makes the new cursor appear in the same 
 // position as the old one.
 void Game::reset_cursor(int id) {
     current_cursor_.player_id = id;
-    current_cursor_.piece = std::make_shared<Triangle>(id);
+    current_cursor_.piece = PieceRegistry::get_piece(id, triangle_shape);
 }
 
 void Game::toggle_cursor_piece() {
@@ -511,15 +628,15 @@ void Game::toggle_cursor_piece() {
 
     switch (current_cursor_.piece->get_piece_type()) {
         case Piece::piece_type::triangle: 
-            current_cursor_.piece = std::make_shared<Rectangle>(id);
+            current_cursor_.piece = PieceRegistry::get_piece(id, rectangle_shape);
             break;
 
         case Piece::piece_type::rectangle: 
-            current_cursor_.piece = std::make_shared<Square>(id);
+            current_cursor_.piece = PieceRegistry::get_piece(id, square_shape);
             break;
 
         case Piece::piece_type::square: 
-            current_cursor_.piece = std::make_shared<Triangle>(id);
+            current_cursor_.piece = PieceRegistry::get_piece(id, triangle_shape);
             break;
 
         default: 
@@ -527,11 +644,20 @@ void Game::toggle_cursor_piece() {
     }
 }
 
+void Game::rotate_cursor_piece(Piece::rotation rot) {
+    const ShapeInfo& info = get_shape_info(current_cursor_.piece->get_shape());
+    const shape_id shape = rot == Piece::rotation::clockwise ? info.clockwise
+        : info.counterclockwise;
+
+    // Pieces are shared, so the rotated piece replaces the cursor's piece
+    current_cursor_.piece = PieceRegistry::get_piece(current_cursor_.player_id, shape);
+}
+
 Game::board_pos Game::find_board_location_of_mouse() {
     
     double xpos = input_handler_->get_mouse_xpos();
     double ypos = input_handler_->get_mouse_ypos();
-    int size = board_.board_size;
+    int size = board_.get_size();
 
     // The xpos and ypos are centered at the center of the board and in block widths.
     // The coordinate system for the world space aligns with the board already, so
@@ -550,10 +676,35 @@ int Game::get_next_actor() {
     return (current_actor_turn_ + 1) % num_actors_;
 }
 
-Board Game::get_board() const {
+const Board& Game::get_board() const {
     return board_;
 }
 
+std::uint64_t Game::get_key() const {
+    return board_.get_key() ^ get_turn_key(current_actor_turn_, half_squares_placed_);
+}
+
+// Turn keys use inputs that piece keys never use, since piece keys are less than 2^63.
+std::uint64_t Game::get_turn_key(int actor, int half_squares_placed) {
+    return mix_bits(~((static_cast<std::uint64_t>(actor) << 1) | half_squares_placed));
+}
+
+int Game::get_current_actor() const {
+    return current_actor_turn_;
+}
+
+int Game::get_half_squares_placed() const {
+    return half_squares_placed_;
+}
+
+int Game::get_num_actors() const {
+    return num_actors_;
+}
+
+int Game::get_board_size() const {
+    return board_.get_size();
+}
+
 Game::Cursor Game::get_cursor() const {
     return current_cursor_;
 }
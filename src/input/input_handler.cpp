@@ -1,25 +1,60 @@
 #include <input/input_handler.hpp>
 
-InputHandler::InputHandler(std::vector<int> keys) {
+InputHandler::InputHandler() {
+    is_key_pressed_.fill(false);
+    last_press_.fill(clock::time_point{});
+    mouse_xpos_ = 0;
+    mouse_ypos_ = 0;
+}
 
-    // Initialize state for given keys
-    for (auto keyIter = keys.begin(); keyIter != keys.end(); ++keyIter) {
-        keys_[*keyIter] = false;
+bool InputHandler::get_key_state(int key) const {
+    if (key < 0 || key >= key_code_count) {
+        return false;
     }
+
+    return is_key_pressed_[key];
 }
 
-// Searches through the map of key presses to find the state of a key. 
-bool InputHandler::get_key_state(int key) const {
-    
-    if (auto search = keys_.find(key); search != keys_.end()) {
-        return search->second;
+void InputHandler::push_key_event(int key, bool isPressed, clock::time_point time) {
+
+    // Keys GLFW doesn't know have a negative code
+    if (key < 0 || key >= key_code_count) {
+        return;
     }
 
-    return false;
+    Event::event_type type = isPressed ? Event::event_type::press : Event::event_type::release;
+    events_.push(Event{type, key, 0, time});
+}
+
+void InputHandler::push_scroll_event(double yoffset, clock::time_point time) {
+    events_.push(Event{Event::event_type::scroll, -1, yoffset, time});
 }
 
-void InputHandler::set_key_state(int key, bool isPressed) {
-    keys_[key] = isPressed;
+bool InputHandler::poll_event(Event& event) {
+    while (events_.pop(event)) {
+        if (event.type == Event::event_type::scroll) {
+            return true;
+        }
+
+        const bool was_pressed = is_key_pressed_[event.key];
+        is_key_pressed_[event.key] = event.type == Event::event_type::press;
+
+        // Only the edge from released to pressed is a press
+        if (event.type != Event::event_type::press || was_pressed) {
+            continue;
+        }
+
+        const clock::time_point last_press = last_press_[event.key];
+
+        if (last_press != clock::time_point{} && event.time - last_press < debounce_time) {
+            continue;
+        }
+
+        last_press_[event.key] = event.time;
+        return true;
+    }
+
+    return false;
 }
 
 double InputHandler::get_mouse_xpos() const {
@@ -37,11 +72,3 @@ double InputHandler::get_mouse_ypos() const {
 void InputHandler::set_mouse_ypos(double ypos) {
     mouse_ypos_ = ypos;
 }
-
-double InputHandler::get_mouse_scroll_yoffset() const {
-    return mouse_yoffset_;
-}
-
-void InputHandler::set_mouse_scroll_yoffset(double yoffset) {
-    mouse_yoffset_ = yoffset;
-}
@@ -7,28 +7,34 @@
 #include <cassert>
 #include <iostream>
 #include <thread>
-#include <chrono>
+#include <cstring>
+#include <algorithm>
 
-#include "components/piece.hpp"
-#include "components/triangle.hpp"
-#include "components/square.hpp"
-#include "components/rectangle.hpp"
 #include "components/board.hpp"
 #include "game.hpp"
+#include "actors/search_player.hpp"
+#include "render/board_renderer.hpp"
 
 #include "input/input_handler.hpp"
+#include "input/keys.hpp"
+
+static_assert(mouse_button_left == GLFW_MOUSE_BUTTON_LEFT);
+static_assert(mouse_button_right == GLFW_MOUSE_BUTTON_RIGHT);
+static_assert(key_code_count == GLFW_KEY_LAST + 1);
 
 // Stores the data that's needed for callback functions. 
 struct WindowData {
     InputHandler input_handler;
     float block_width;
-};
 
-// Structure for storing a colour
-struct Color {
-    GLfloat r, g, b, a;
+    // Whether the window needs to be drawn again even if the game hasn't changed.
+    bool needs_redraw = true;
 };
 
+// The longest time in seconds to wait for input before checking if a computer
+// player has finished thinking.
+static constexpr double idle_timeout = 0.05;
+
 static void error_callback(int error, const char* description)
 {
     fputs(description, stderr);
@@ -41,7 +47,7 @@ static void key_callback(GLFWwindow* window, int key, int scancode, int action,
     } else {
         // Get the input handler from the window data. 
         WindowData* window_data = static_cast<WindowData*>(glfwGetWindowUserPointer(window));
-        window_data->input_handler.set_key_state(key, action == GLFW_PRESS || action == GLFW_REPEAT);
+        window_data->input_handler.push_key_event(key, action == GLFW_PRESS || action == GLFW_REPEAT);
     }
 }
 
@@ -50,7 +56,7 @@ static void mouse_button_callback(GLFWwindow* window, int button, int action, in
     // Get the input handler from the window data. 
     WindowData* window_data = static_cast<WindowData*>(glfwGetWindowUserPointer(window));
     // Either GLFW_PRESS or GLFW_RELEASE.
-    window_data->input_handler.set_key_state(button, action == GLFW_PRESS);
+    window_data->input_handler.push_key_event(button, action == GLFW_PRESS);
 }
 
 // `xoffset` and `yoffset` are integer values of either -1, 0 or 1.
@@ -60,8 +66,7 @@ static void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
 {
     // Get the input handler from the window data. 
     WindowData* window_data = static_cast<WindowData*>(glfwGetWindowUserPointer(window));
-    // Either GLFW_PRESS or GLFW_RELEASE.
-    window_data->input_handler.set_mouse_scroll_yoffset(yoffset);
+    window_data->input_handler.push_scroll_event(yoffset);
 }
 
 // Converts screen space mouse coordinates to world space coordinates.
@@ -81,6 +86,13 @@ void convert_mouse_screen_coordinates_to_world_coordinates(double mouse_x, doubl
         &zpos);
 }
 
+// Called when the contents of the window were lost, such as when it was uncovered.
+static void refresh_callback(GLFWwindow* window)
+{
+    WindowData* window_data = static_cast<WindowData*>(glfwGetWindowUserPointer(window));
+    window_data->needs_redraw = true;
+}
+
 static void cursor_position_callback(GLFWwindow* window, double xpos, double ypos) {
 
     double world_xpos;
@@ -96,189 +108,80 @@ static void cursor_position_callback(GLFWwindow* window, double xpos, double ypo
 }
 
 
-// Draws a triangle on the interface given three points, number of blocks on the board,
-// the width of each block, the location of the triangle on the board and the color.
-void draw_triangle_from_points(const std::vector<Piece::Point> points, const int blocks,
-    const float block_width, const int board_x, const int board_y,
-    const Color color) {
-
-    const int center_offset = blocks / 2;
-
-    glBegin(GL_TRIANGLES);
-    glColor4fv(&color.r);
-
-    for (auto pointIter = points.begin(); pointIter != points.end();
-        ++pointIter) {
-        
-        // Pieces are centered at 0,0 and have a default width of 2
-        Piece::Point p = *pointIter;
+// Takes the number of blocks on each side of the board as an optional argument,
+// followed by `human`, `cpu` or `mcts` for each player and then an opening book
+// for the computer players.
+int main(int argc, char** argv)
+{
 
-        // Need to scale down by half
-        float rescaled_x = (p.x + 1.0f) / 2.0f;
-        float rescaled_y = (p.y + 1.0f) / 2.0f;
+    // Setup window data for callbacks.
+    WindowData window_data;
 
-        // Shift into position
-        float new_x = (rescaled_x - center_offset + board_x) * block_width;
+    // Game Settings
+    int blocks = Board::default_board_size;
+    int num_players = 2;
 
-        // Need to offset by -1 for y due to 0,0 being top left for board
-        // where top left of interface is -4 * board_width, 4 * board_width
-        float new_y = (rescaled_y + center_offset - board_y - 1) * block_width;
-        
-        glVertex2f(new_x, new_y);
+    if (argc > 1) {
+        blocks = atoi(argv[1]);
     }
-    
-    glEnd();
-}
-
-// Given a pointer to a triangle and the board width in blocks
-// draws the triangle
-void draw_triangle(const std::shared_ptr<Triangle> triangle, const int blocks, 
-    const float block_width, const int board_x, const int board_y,
-    const Color color) {
-    
-    const std::vector<Piece::Point> points = triangle->get_points();
-
-    draw_triangle_from_points(points, blocks,
-        block_width, board_x, board_y, color);
-}
-
-void draw_quad(const std::shared_ptr<Piece> quad, const int blocks, 
-    const float block_width, const int board_x, const int board_y,
-    const Color color) {
-
-    const std::vector<Piece::Point> points = quad->get_points();
 
-    // Form first triangle from first three points
-    draw_triangle_from_points({points[0], points[1], points[2]}, blocks,
-        block_width, board_x, board_y, color);
-
-    // Form first triangle from last two points and first point
-    draw_triangle_from_points({points[2], points[3], points[0]}, blocks,
-        block_width, board_x, board_y, color);
-
-}
-
-void draw_piece(const std::shared_ptr<Piece> piece, const int blocks,
-    const float block_width, const int board_x, const int board_y,
-    const Color player_color) {
-
-
-    if (piece->get_piece_type() == Piece::piece_type::triangle) {
-        draw_triangle(std::dynamic_pointer_cast<Triangle>(piece), blocks,
-            block_width, board_x, board_y, player_color);
-    } else if (piece->get_piece_type() == Piece::piece_type::square || 
-               piece->get_piece_type() == Piece::piece_type::rectangle) {
-        draw_quad(piece, blocks,
-            block_width, board_x, board_y, player_color);
-    } else {
-        assert(false);
+    if (blocks < 2 || blocks > Board::max_board_size) {
+        std::cerr << "The board size must be between 2 and " << Board::max_board_size << "\n";
+        exit(EXIT_FAILURE);
     }
-}
-
-// Draw lines for game board
-void draw_board_lines(int blocks, float block_width) {
-    
-    int lines = blocks + 1;
 
-    float total_width = block_width * blocks;
+    // Game Objects
+    Game game(blocks, num_players, &window_data.input_handler);
 
-    float top = total_width / 2;
-    float bottom = -top;
+    // Players are people at the mouse unless they're chosen to be the computer
+    const int cpu_threads = std::max(1u, std::thread::hardware_concurrency());
 
-    glBegin(GL_LINES);
-    // Line colour
-    glColor3f(0.0f, 0.0f, 0.0f);
+    AlphaBetaSearch::Limits cpu_limits;
+    cpu_limits.threads = cpu_threads;
 
-    // Try drawing lines
-    for (int i = -4; i <= 4; i++) {
-        float horizontal_pos = block_width * i;
-        glVertex2f(horizontal_pos, top);
-        glVertex2f(horizontal_pos, bottom);
+    MonteCarloSearch::Limits mcts_limits;
+    mcts_limits.threads = cpu_threads;
 
-        // Horz
-        glVertex2f(top, horizontal_pos);
-        glVertex2f(bottom, horizontal_pos);
-    }
+    // The book is only mapped into memory, so it's ready as soon as it's open
+    std::shared_ptr<OpeningBook> opening_book;
 
-    glEnd();
-}
+    if (num_players + 2 < argc) {
+        opening_book = std::make_shared<OpeningBook>();
 
-// Given an id returns the associated colour for that player
-Color get_player_color(int id) {
-    Color player_color;
+        if (!opening_book->open(argv[num_players + 2])) {
+            std::cerr << "Could not open the opening book " << argv[num_players + 2] << "\n";
+            exit(EXIT_FAILURE);
+        }
 
-    if (id == 0) {
-        player_color = Color{1.0f, 0.0f, 0.0f, 1.0f};
-    } else {
-        player_color = Color{0.0f, 0.0f, 1.0f, 1.0f};
+        if (opening_book->get_board_size() != blocks || opening_book->get_players() != num_players) {
+            std::cerr << "The opening book is for a different board size or number of players\n";
+            exit(EXIT_FAILURE);
+        }
     }
 
-    return player_color;
-}
-
-void draw_board_pieces(Board &board, int blocks, float block_width) {
-
-   // Go through each slot on the board
-   const Board::board_pointer board_array = board.get_board();
-
-   for (int i = 0; i < Board::board_size; ++i) {
-        for (int j = 0; j < Board::board_size; ++j) {
-
-            // Draw pieces in each slot
-            if (board_array[i][j].first) {
-                const std::shared_ptr<Piece> first_piece = board_array[i][j].first;
-                Color color = get_player_color(first_piece->get_owner_id());
-                draw_piece(first_piece, blocks, block_width, j, i, color);
-            }
-            
-            if (board_array[i][j].second) {
-                const std::shared_ptr<Piece> second_piece = board_array[i][j].second;
-                Color color = get_player_color(second_piece->get_owner_id());
-                draw_piece(second_piece, blocks, block_width, j, i, color);
-            }
-
+    for (int i = 0; i < num_players && i + 2 < argc; ++i) {
+        if (std::strcmp(argv[i + 2], "cpu") == 0) {
+            auto player = std::make_unique<AlphaBetaPlayer>(cpu_limits);
+            player->set_opening_book(opening_book);
+            game.set_actor(i, std::move(player));
+        } else if (std::strcmp(argv[i + 2], "mcts") == 0) {
+            auto player = std::make_unique<MonteCarloPlayer>(mcts_limits);
+            player->set_opening_book(opening_book);
+            game.set_actor(i, std::move(player));
+        } else if (std::strcmp(argv[i + 2], "human") != 0) {
+            std::cerr << "Players must be either human, cpu or mcts\n";
+            exit(EXIT_FAILURE);
         }
-   }
-}
-
-void draw_cursor_piece(Game::Cursor& cursor, int blocks, float block_width) {
-    Color color = get_player_color(cursor.player_id);
-    // Lighten colours and add transparency
-    color.r += 0.2f;
-    color.g += 0.2f;
-    color.b += 0.2f;
-    color.a = 0.8f;
-    draw_piece(cursor.piece, blocks, block_width, cursor.x, cursor.y, color);
-}
-
-int main(void)
-{
-
-    // Setup window data for callbacks.
-    WindowData window_data;
-
-    // Setup key handler
-    std::vector<int> key_list = { // Keys we need to care about for the game
-        GLFW_MOUSE_BUTTON_LEFT,
-        GLFW_MOUSE_BUTTON_RIGHT,
-    };
-
-    window_data.input_handler = InputHandler(key_list);
-
-    // Game Settings
-    int blocks = 8;
-    int num_players = 2;
+    }
 
     // Graphic Settings
-    float block_width = 0.2f;
+    // Keep the board the same size on screen no matter how many blocks it has
+    const float board_width = 1.6f;
+    float block_width = board_width / blocks;
     window_data.block_width = block_width;
-
-    // Game Objects
-    Game game(blocks, num_players, &window_data.input_handler);
    
     bool game_finished = false;
     bool end_game_stats_printed = false;
-    Board final_board; // Store game end board
 
     // Create Window
     GLFWwindow* window;
@@ -293,6 +196,9 @@ int main(void)
     }
     glfwMakeContextCurrent(window);
 
+    // Draw at most once per refresh of the screen
+    glfwSwapInterval(1);
+
     // Add window data to window.
     glfwSetWindowUserPointer(window, &window_data);
 
@@ -301,52 +207,62 @@ int main(void)
     glfwSetCursorPosCallback(window, cursor_position_callback);
     glfwSetMouseButtonCallback(window, mouse_button_callback);
     glfwSetScrollCallback(window, scroll_callback);
+    glfwSetWindowRefreshCallback(window, refresh_callback);
 
     // Setup alpha blending
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glEnable(GL_BLEND);
     glClearColor(0.8f, 0.8f, 0.8f, 0.8f);
 
+    // Keeps the board on the graphics card between frames
+    BoardRenderer renderer(blocks, block_width);
+
+    // The size of the window the last time it was drawn
+    int last_width = 0;
+    int last_height = 0;
+
     // Main rendering loop
     while (!glfwWindowShouldClose(window))
     {
         float ratio;
         int width, height;
         glfwGetFramebufferSize(window, &width, &height);
-        ratio = width / (float) height;
-        glViewport(0, 0, width, height);
-
-        // Clear colours
-        glClear(GL_COLOR_BUFFER_BIT);
-        glMatrixMode(GL_PROJECTION);
-        glLoadIdentity();
-        glOrtho(-ratio, ratio, -1.f, 1.f, 1.f, -1.f);
-        glMatrixMode(GL_MODELVIEW);
-       
+
+        // Only set up the view again when the window has changed
+        if (width != last_width || height != last_height || window_data.needs_redraw) {
+            ratio = width / (float) height;
+            glViewport(0, 0, width, height);
+
+            glMatrixMode(GL_PROJECTION);
+            glLoadIdentity();
+            glOrtho(-ratio, ratio, -1.f, 1.f, 1.f, -1.f);
+            glMatrixMode(GL_MODELVIEW);
+
+            renderer.redraw_all();
+            last_width = width;
+            last_height = height;
+            window_data.needs_redraw = false;
+        }
+
+        // Nothing changes until there's input, unless an actor is still acting
+        bool is_idle = true;
+
         // Run game turns
         if (!game_finished) {
 
-            // Check if game is done
-            final_board.clear();
-            game_finished = game.check_if_game_is_finished(final_board);
-            game.progress_turn();
-        
-            // Board and Cursor drawing
-            Board board = game.get_board();
-            Game::Cursor cursor = game.get_cursor();
+            // Check if game is done, which only reruns once a piece is placed
+            game_finished = game.is_finished();
+            is_idle = game.progress_turn() == Action::NONE;
 
-            // Draw pieces of board and cursor
-            draw_board_pieces(board, blocks, block_width);
-            draw_cursor_piece(cursor, blocks, block_width);
+            // Board and Cursor drawing
+            renderer.set_board(game.get_board());
+            renderer.set_cursor(game.get_cursor());
         } else {
-            // Add a delay before updating to game end.
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
-            
             if (!end_game_stats_printed) {
                 // Get the scores
-                const float red_score = final_board.get_score(0);
-                const int max_squares = Board::board_size * Board::board_size;
-                const float blue_score = max_squares - red_score;
+                const std::vector<float>& scores = game.get_final_scores();
+                const float red_score = scores[0];
+                const float blue_score = scores[1];
 
                 if (red_score > blue_score) {
                     std::cout << "Red Wins!\n";
@@ -363,13 +279,25 @@ int main(void)
                 end_game_stats_printed = true;
             }
 
-            draw_board_pieces(final_board, blocks, block_width);
+            renderer.set_board(game.get_final_board());
+            renderer.hide_cursor();
+        }
+
+        // Draw pieces of board and cursor, then the lines of the board, but only
+        // where something has changed
+        if (renderer.draw_changes()) {
+            glfwSwapBuffers(window);
+        }
+
+        // Sleep until there's input when idle. Computer players act without any
+        // input, so the wait is cut short to check on them while the game runs.
+        if (game_finished) {
+            glfwWaitEvents();
+        } else if (is_idle) {
+            glfwWaitEventsTimeout(idle_timeout);
+        } else {
+            glfwPollEvents();
         }
-        // Draw lines of board and cursor
-        draw_board_lines(blocks, block_width);
-        
-        glfwSwapBuffers(window);
-        glfwPollEvents();
     }
 
     glfwDestroyWindow(window);
@@ -0,0 +1,265 @@
+#include <cassert>
+
+#include "record/game_record.hpp"
+#include "components/shapes.hpp"
+
+// The most bytes a 64 bit number takes with seven bits per byte.
+static constexpr int max_number_bytes = 10;
+
+// How much of a record is read from the stream at a time.
+static constexpr std::size_t read_buffer_size = 1 << 16;
+
+GameRecordWriter::GameRecordWriter(std::ostream& out) : out_(out) {
+    blocks_ = 0;
+    is_recording_ = false;
+
+    out_.write(record_magic.data(), record_magic.size());
+    out_.put(static_cast<char>(record_version));
+}
+
+void GameRecordWriter::begin_game(const GameRecordHeader& header) {
+    assert(!is_recording_);
+    assert(header.blocks >= 2 && header.blocks <= Board::max_board_size);
+    assert(header.players == Board::initial_square_players);
+
+    write_number(header.blocks);
+    write_number(header.players);
+    write_number(header.seed);
+
+    blocks_ = header.blocks;
+    is_recording_ = true;
+}
+
+void GameRecordWriter::add_placement(const Game::Placement& placement) {
+    assert(is_recording_);
+    assert(placement.x >= 0 && placement.x < blocks_);
+    assert(placement.y >= 0 && placement.y < blocks_);
+    assert(placement.shape < shape_count);
+
+    const std::uint64_t slot = static_cast<std::uint64_t>(placement.y) * blocks_ + placement.x;
+    write_number(slot * shape_count + placement.shape + 1);
+}
+
+void GameRecordWriter::end_game() {
+    assert(is_recording_);
+
+    write_number(0);
+    is_recording_ = false;
+}
+
+void GameRecordWriter::write_number(std::uint64_t value) {
+    char bytes[max_number_bytes];
+    int count = 0;
+
+    // The top bit of each byte says if there are more bytes
+    while (value >= 0x80) {
+        bytes[count++] = static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+
+    bytes[count++] = static_cast<char>(value);
+    out_.write(bytes, count);
+}
+
+GameRecordReader::GameRecordReader(std::istream& in) : in_(in), buffer_(read_buffer_size) {
+    position_ = 0;
+    size_ = 0;
+    is_in_game_ = false;
+    blocks_ = 0;
+
+    // Check the start of the file
+    is_valid_ = true;
+
+    for (char expected : record_magic) {
+        std::uint8_t byte;
+
+        if (!read_byte(byte) || static_cast<char>(byte) != expected) {
+            is_valid_ = false;
+            return;
+        }
+    }
+
+    std::uint8_t version = 0;
+    is_valid_ = read_byte(version) && version == record_version;
+}
+
+bool GameRecordReader::is_valid() const {
+    return is_valid_;
+}
+
+bool GameRecordReader::next_game(GameRecordHeader& header) {
+
+    // Skip what's left of the current game
+    Game::Placement placement;
+    while (next_placement(placement)) {}
+
+    if (!is_valid_) {
+        return false;
+    }
+
+    // The record can only end between games
+    if (position_ == size_ && !fill_buffer()) {
+        return false;
+    }
+
+    std::uint64_t blocks;
+    std::uint64_t players;
+    std::uint64_t seed;
+
+    // Only the players with an initial square can play, and a record asking
+    // for more would make the replayer allocate boards for all of them
+    if (!read_number(blocks) || !read_number(players) || !read_number(seed) || blocks < 2
+        || blocks > Board::max_board_size || players != Board::initial_square_players) {
+        is_valid_ = false;
+        return false;
+    }
+
+    header.blocks = blocks;
+    header.players = players;
+    header.seed = seed;
+
+    blocks_ = header.blocks;
+    is_in_game_ = true;
+
+    return true;
+}
+
+bool GameRecordReader::next_placement(Game::Placement& placement) {
+    if (!is_in_game_) {
+        return false;
+    }
+
+    std::uint64_t value;
+
+    if (!read_number(value)) {
+        is_valid_ = false;
+        is_in_game_ = false;
+        return false;
+    }
+
+    // Zero ends the game
+    if (value == 0) {
+        is_in_game_ = false;
+        return false;
+    }
+
+    const std::uint64_t slot = (value - 1) / shape_count;
+
+    if (slot >= static_cast<std::uint64_t>(blocks_) * blocks_) {
+        is_valid_ = false;
+        is_in_game_ = false;
+        return false;
+    }
+
+    placement.x = slot % blocks_;
+    placement.y = slot / blocks_;
+    placement.shape = (value - 1) % shape_count;
+
+    return true;
+}
+
+bool GameRecordReader::fill_buffer() {
+    in_.read(buffer_.data(), buffer_.size());
+    size_ = in_.gcount();
+    position_ = 0;
+
+    return size_ > 0;
+}
+
+bool GameRecordReader::read_number(std::uint64_t& value) {
+    value = 0;
+
+    for (int i = 0; i < max_number_bytes; ++i) {
+        std::uint8_t byte;
+
+        if (!read_byte(byte)) {
+            return false;
+        }
+
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << (7 * i);
+
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+
+    // Too many bytes for a 64 bit number
+    return false;
+}
+
+GameReplayer::GameReplayer(std::istream& in) : reader_(in), board_(2) {
+    is_valid_ = reader_.is_valid();
+    current_actor_ = 0;
+    half_squares_placed_ = 0;
+}
+
+bool GameReplayer::next_game() {
+    if (!reader_.next_game(header_)) {
+        return false;
+    }
+
+    // Reuse the board if it's the same size
+    if (board_.get_size() == header_.blocks && board_.get_players() == header_.players) {
+        board_.clear();
+    } else {
+        board_ = Board(header_.blocks, header_.players);
+    }
+
+    current_actor_ = 0;
+    half_squares_placed_ = 0;
+
+    return true;
+}
+
+bool GameReplayer::step() {
+    Game::Placement placement;
+
+    if (!reader_.next_placement(placement)) {
+        return false;
+    }
+
+    if (!board_.place_piece(current_actor_, placement.shape, placement.x, placement.y)) {
+        is_valid_ = false;
+        return false;
+    }
+
+    // Turns move on the same way as in a game
+    half_squares_placed_ += placement.shape == square_shape ? 2 : 1;
+
+    if (half_squares_placed_ == 2) {
+        half_squares_placed_ = 0;
+        current_actor_ = (current_actor_ + 1) % header_.players;
+    }
+
+    return true;
+}
+
+int GameReplayer::replay_game() {
+    int placements = 0;
+
+    while (step()) {
+        ++placements;
+    }
+
+    return placements;
+}
+
+bool GameReplayer::is_valid() const {
+    return is_valid_ && reader_.is_valid();
+}
+
+const GameRecordHeader& GameReplayer::get_header() const {
+    return header_;
+}
+
+const Board& GameReplayer::get_board() const {
+    return board_;
+}
+
+int GameReplayer::get_current_actor() const {
+    return current_actor_;
+}
+
+int GameReplayer::get_half_squares_placed() const {
+    return half_squares_placed_;
+}
@@ -0,0 +1,286 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+
+#include "record/opening_book.hpp"
+#include "components/shapes.hpp"
+
+namespace {
+
+// The header at the start of an opening book.
+struct BookHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t blocks;
+    std::uint32_t players;
+    std::uint64_t count;
+};
+
+constexpr char book_magic[4] = {'B', 'K', 'O', 'B'};
+constexpr std::uint32_t book_version = 1;
+
+// The entries start after the header at a multiple of eight bytes.
+constexpr std::size_t header_size = 32;
+static_assert(sizeof(BookHeader) <= header_size);
+
+// An entry of the book, which are sorted by key.
+struct BookEntry {
+    std::uint64_t key;
+    std::uint16_t x;
+    std::uint16_t y;
+    std::uint8_t shape;
+    std::uint8_t depth;
+    std::uint16_t reserved;
+};
+
+static_assert(sizeof(BookEntry) == 16);
+
+// Reflecting the board swaps the x and y of every point of a piece, so each
+// shape becomes the shape with the swapped points.
+constexpr std::array<shape_id, shape_count> make_reflected_shapes() {
+    std::array<shape_id, shape_count> reflected{};
+
+    for (shape_id shape = 0; shape < shape_count; ++shape) {
+        const ShapeInfo& info = get_shape_info(shape);
+        std::uint16_t mask = 0;
+
+        for (int i = 0; i < info.point_count; ++i) {
+            const Piece::Point point = info.points[i];
+            mask |= 1 << ((1 - point.x) * 3 + point.y + 1);
+        }
+
+        for (shape_id other = 0; other < shape_count; ++other) {
+            if (get_shape_info(other).point_mask == mask) {
+                reflected[shape] = other;
+            }
+        }
+    }
+
+    return reflected;
+}
+
+constexpr std::array<shape_id, shape_count> reflected_shapes = make_reflected_shapes();
+
+// Every shape has a reflection, and reflecting it again gives back the shape.
+constexpr bool check_reflected_shapes() {
+    for (shape_id shape = 0; shape < shape_count; ++shape) {
+        if (reflected_shapes[reflected_shapes[shape]] != shape) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static_assert(check_reflected_shapes());
+
+}
+
+Game::Placement reflect_placement(const Game::Placement& placement, int blocks) {
+    return Game::Placement{blocks - 1 - placement.y, blocks - 1 - placement.x,
+        reflected_shapes[placement.shape]};
+}
+
+void reflect_board(const Board& board, Board& reflected) {
+    assert(board.get_size() == reflected.get_size());
+    assert(board.get_players() == reflected.get_players());
+
+    const int size = board.get_size();
+
+    // The initial squares are on the diagonal, so they're already in place
+    reflected.clear();
+
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            const Board::slot_contents slot = board.get_slot(x, y);
+
+            // Place the halves in the same order so they're found the same way
+            for (const Board::slot_piece& piece : {slot.first, slot.second}) {
+                if (piece) {
+                    reflected.place_piece(piece.owner, reflected_shapes[piece.shape],
+                        size - 1 - y, size - 1 - x);
+                }
+            }
+        }
+    }
+}
+
+std::uint64_t get_book_key(const Board& board, int actor, int half_squares_placed,
+    bool& is_reflected) {
+    const int size = board.get_size();
+    std::uint64_t reflected_key = 0;
+
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            const Board::slot_contents slot = board.get_slot(x, y);
+
+            for (const Board::slot_piece& piece : {slot.first, slot.second}) {
+                if (piece) {
+                    reflected_key ^= Board::get_piece_key(piece.owner,
+                        reflected_shapes[piece.shape], size - 1 - y, size - 1 - x);
+                }
+            }
+        }
+    }
+
+    is_reflected = reflected_key < board.get_key();
+    const std::uint64_t key = is_reflected ? reflected_key : board.get_key();
+
+    return key ^ Game::get_turn_key(actor, half_squares_placed);
+}
+
+OpeningBookWriter::OpeningBookWriter(int blocks, int players) {
+    assert(blocks >= 2 && blocks <= Board::max_board_size);
+    assert(players >= 2);
+
+    blocks_ = blocks;
+    players_ = players;
+}
+
+void OpeningBookWriter::add_move(const Board& board, int actor, int half_squares_placed,
+    const Game::Placement& placement, int depth) {
+    assert(board.get_size() == blocks_ && board.get_players() == players_);
+
+    bool is_reflected;
+    const std::uint64_t key = get_book_key(board, actor, half_squares_placed, is_reflected);
+
+    const Game::Placement stored = is_reflected ? reflect_placement(placement, blocks_) : placement;
+    moves_.emplace(key, Move{stored, depth});
+}
+
+bool OpeningBookWriter::contains(const Board& board, int actor, int half_squares_placed) const {
+    bool is_reflected;
+    return moves_.contains(get_book_key(board, actor, half_squares_placed, is_reflected));
+}
+
+bool OpeningBookWriter::write(const std::string& path) const {
+    std::vector<BookEntry> entries;
+    entries.reserve(moves_.size());
+
+    for (const auto& [key, move] : moves_) {
+        entries.push_back(BookEntry{key, static_cast<std::uint16_t>(move.placement.x),
+            static_cast<std::uint16_t>(move.placement.y), move.placement.shape,
+            static_cast<std::uint8_t>(std::clamp(move.depth, 0, 255)), 0});
+    }
+
+    // Sort the entries so positions can be found with a binary search
+    std::sort(entries.begin(), entries.end(), [](const BookEntry& lhs, const BookEntry& rhs) {
+        return lhs.key < rhs.key;
+    });
+
+    BookHeader header{};
+    std::memcpy(header.magic, book_magic, sizeof(book_magic));
+    header.version = book_version;
+    header.blocks = blocks_;
+    header.players = players_;
+    header.count = entries.size();
+
+    char header_bytes[header_size] = {};
+    std::memcpy(header_bytes, &header, sizeof(header));
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(header_bytes, header_size);
+    out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(BookEntry));
+    out.close();
+
+    return !out.fail();
+}
+
+std::uint64_t OpeningBookWriter::get_move_count() const {
+    return moves_.size();
+}
+
+OpeningBook::OpeningBook() {
+    blocks_ = 0;
+    players_ = 0;
+    count_ = 0;
+    entries_ = nullptr;
+}
+
+bool OpeningBook::open(const std::string& path) {
+    close();
+
+    if (!file_.open(path, header_size)) {
+        return false;
+    }
+
+    const BookHeader header = load_unaligned<BookHeader>(file_.data());
+
+    const bool is_book = std::memcmp(header.magic, book_magic, sizeof(book_magic)) == 0
+        && header.version == book_version && header.blocks >= 2
+        && header.blocks <= Board::max_board_size && header.players >= 2
+        && (file_.size() - header_size) / sizeof(BookEntry) == header.count
+        && (file_.size() - header_size) % sizeof(BookEntry) == 0;
+
+    if (!is_book) {
+        close();
+        return false;
+    }
+
+    blocks_ = header.blocks;
+    players_ = header.players;
+    count_ = header.count;
+    entries_ = file_.data() + header_size;
+
+    return true;
+}
+
+void OpeningBook::close() {
+    file_.close();
+    blocks_ = 0;
+    players_ = 0;
+    count_ = 0;
+    entries_ = nullptr;
+}
+
+std::uint64_t OpeningBook::size() const {
+    return count_;
+}
+
+int OpeningBook::get_board_size() const {
+    return blocks_;
+}
+
+int OpeningBook::get_players() const {
+    return players_;
+}
+
+bool OpeningBook::find(const Board& board, int actor, int half_squares_placed,
+    Game::Placement& placement, int& depth) const {
+    if (count_ == 0 || board.get_size() != blocks_ || board.get_players() != players_) {
+        return false;
+    }
+
+    bool is_reflected;
+    const std::uint64_t key = get_book_key(board, actor, half_squares_placed, is_reflected);
+
+    const std::uint64_t index = find_first_key(entries_, count_, sizeof(BookEntry), key);
+
+    if (index == count_) {
+        return false;
+    }
+
+    const BookEntry entry = load_unaligned<BookEntry>(entries_ + index * sizeof(BookEntry));
+
+    if (entry.key != key || entry.shape >= shape_count || entry.x >= blocks_
+        || entry.y >= blocks_) {
+        return false;
+    }
+
+    placement = Game::Placement{entry.x, entry.y, entry.shape};
+    depth = entry.depth;
+
+    if (is_reflected) {
+        placement = reflect_placement(placement, blocks_);
+    }
+
+    return true;
+}
+
+bool OpeningBook::find(const Board& board, int actor, int half_squares_placed,
+    Game::Placement& placement) const {
+    int depth;
+    return find(board, actor, half_squares_placed, placement, depth);
+}
@@ -0,0 +1,293 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+#include "record/position_store.hpp"
+#include "components/shapes.hpp"
+
+namespace {
+
+// The header at the start of a position store.
+struct StoreHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t blocks;
+    std::uint32_t players;
+    std::uint64_t record_size;
+    std::uint64_t count;
+    std::uint64_t index_offset;
+};
+
+constexpr char store_magic[4] = {'B', 'K', 'P', 'S'};
+constexpr std::uint32_t store_version = 2;
+
+// The records start after the header at a multiple of eight bytes.
+constexpr std::size_t header_size = 64;
+static_assert(sizeof(StoreHeader) <= header_size);
+
+// Where the parts of a record are.
+constexpr std::size_t key_offset = 0;
+constexpr std::size_t actor_offset = 8;
+constexpr std::size_t half_squares_offset = 9;
+constexpr std::size_t scores_offset = 10;
+
+// Scores are counts of half squares, which can be more than 16 bits hold on
+// large boards.
+using stored_score = std::uint32_t;
+
+std::size_t get_slots_offset(int players) {
+    return scores_offset + sizeof(stored_score) * players;
+}
+
+std::size_t get_record_size(int blocks, int players) {
+    const std::size_t size = get_slots_offset(players) + 2 * blocks * blocks;
+    return (size + 7) / 8 * 8;
+}
+
+// Pieces are stored in a byte with zero for no piece.
+unsigned char encode_piece(const Board::slot_piece& piece) {
+    if (!piece) {
+        return 0;
+    }
+
+    return 1 + piece.owner * shape_count + piece.shape;
+}
+
+Board::slot_piece decode_piece(unsigned char code) {
+    if (code == 0) {
+        return Board::slot_piece{};
+    }
+
+    return Board::slot_piece{(code - 1) / shape_count,
+        static_cast<shape_id>((code - 1) % shape_count)};
+}
+
+}
+
+PositionView::PositionView(const unsigned char* data, int blocks, int players)
+    : data_(data), blocks_(blocks), players_(players) {}
+
+std::uint64_t PositionView::get_key() const {
+    return load_unaligned<std::uint64_t>(data_ + key_offset);
+}
+
+int PositionView::get_current_actor() const {
+    return data_[actor_offset];
+}
+
+int PositionView::get_half_squares_placed() const {
+    return data_[half_squares_offset];
+}
+
+float PositionView::get_final_score(int player) const {
+    assert(player >= 0 && player < players_);
+    return load_unaligned<stored_score>(data_ + scores_offset + sizeof(stored_score) * player) * 0.5f;
+}
+
+Board::slot_contents PositionView::get_slot(int x, int y) const {
+    const unsigned char* slot = data_ + get_slots_offset(players_) + 2 * (y * blocks_ + x);
+    return Board::slot_contents{decode_piece(slot[0]), decode_piece(slot[1])};
+}
+
+void PositionView::copy_to_board(Board& board) const {
+    assert(board.get_size() == blocks_ && board.get_players() == players_);
+
+    // The initial squares are stored with the rest of the pieces
+    board.clear();
+
+    for (int y = 0; y < blocks_; ++y) {
+        for (int x = 0; x < blocks_; ++x) {
+            const Board::slot_contents slot = get_slot(x, y);
+            const Board::slot_contents existing = board.get_slot(x, y);
+
+            if (slot.first && !existing.first) {
+                board.place_piece(slot.first.owner, slot.first.shape, x, y);
+            }
+
+            if (slot.second) {
+                board.place_piece(slot.second.owner, slot.second.shape, x, y);
+            }
+        }
+    }
+}
+
+PositionStoreWriter::PositionStoreWriter(int blocks, int players) {
+    assert(blocks >= 2 && blocks <= Board::max_board_size);
+    assert(players >= 2 && players <= max_position_store_players);
+
+    blocks_ = blocks;
+    players_ = players;
+    record_size_ = get_record_size(blocks, players);
+    record_.resize(record_size_);
+}
+
+bool PositionStoreWriter::open(const std::string& path) {
+    out_.open(path, std::ios::binary | std::ios::trunc);
+    keys_.clear();
+
+    // Leave space for the header, which is written once the count is known
+    const char empty_header[header_size] = {};
+    out_.write(empty_header, header_size);
+
+    return static_cast<bool>(out_);
+}
+
+void PositionStoreWriter::add_position(const Board& board, std::uint64_t key, int current_actor,
+    int half_squares_placed, const std::vector<float>& final_scores) {
+    assert(out_.is_open());
+    assert(board.get_size() == blocks_ && board.get_players() == players_);
+    assert(static_cast<int>(final_scores.size()) == players_);
+
+    std::fill(record_.begin(), record_.end(), 0);
+    unsigned char* record = record_.data();
+
+    store_unaligned<std::uint64_t>(record + key_offset, key);
+    record[actor_offset] = current_actor;
+    record[half_squares_offset] = half_squares_placed;
+
+    // Scores are always a whole number of half squares
+    for (int i = 0; i < players_; ++i) {
+        store_unaligned<stored_score>(record + scores_offset + sizeof(stored_score) * i,
+            std::lround(final_scores[i] * 2));
+    }
+
+    unsigned char* slots = record + get_slots_offset(players_);
+
+    for (int y = 0; y < blocks_; ++y) {
+        for (int x = 0; x < blocks_; ++x) {
+            const Board::slot_contents slot = board.get_slot(x, y);
+            slots[2 * (y * blocks_ + x)] = encode_piece(slot.first);
+            slots[2 * (y * blocks_ + x) + 1] = encode_piece(slot.second);
+        }
+    }
+
+    keys_.emplace_back(key, keys_.size());
+    out_.write(reinterpret_cast<const char*>(record), record_size_);
+}
+
+void PositionStoreWriter::add_position(const Game& game, const std::vector<float>& final_scores) {
+    add_position(game.get_board(), game.get_key(), game.get_current_actor(),
+        game.get_half_squares_placed(), final_scores);
+}
+
+bool PositionStoreWriter::finish() {
+    assert(out_.is_open());
+
+    // Sort the keys so positions can be found with a binary search
+    std::sort(keys_.begin(), keys_.end());
+
+    for (const auto& [key, record] : keys_) {
+        const std::uint64_t entry[2] = {key, record};
+        out_.write(reinterpret_cast<const char*>(entry), sizeof(entry));
+    }
+
+    StoreHeader header{};
+    std::memcpy(header.magic, store_magic, sizeof(store_magic));
+    header.version = store_version;
+    header.blocks = blocks_;
+    header.players = players_;
+    header.record_size = record_size_;
+    header.count = keys_.size();
+    header.index_offset = header_size + keys_.size() * record_size_;
+
+    out_.seekp(0);
+    out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out_.close();
+
+    const bool is_written = !out_.fail();
+    keys_.clear();
+
+    return is_written;
+}
+
+std::uint64_t PositionStoreWriter::get_position_count() const {
+    return keys_.size();
+}
+
+PositionStore::PositionStore() {
+    blocks_ = 0;
+    players_ = 0;
+    record_size_ = 0;
+    count_ = 0;
+    records_ = nullptr;
+    index_ = nullptr;
+}
+
+bool PositionStore::open(const std::string& path) {
+    close();
+
+    if (!file_.open(path, header_size)) {
+        return false;
+    }
+
+    const StoreHeader header = load_unaligned<StoreHeader>(file_.data());
+
+    const bool is_store = std::memcmp(header.magic, store_magic, sizeof(store_magic)) == 0
+        && header.version == store_version && header.blocks >= 2
+        && header.blocks <= Board::max_board_size && header.players >= 2
+        && header.players <= max_position_store_players
+        && header.record_size == get_record_size(header.blocks, header.players)
+        && header.index_offset == header_size + header.count * header.record_size
+        && file_.size() == header.index_offset + header.count * sizeof(IndexEntry);
+
+    if (!is_store) {
+        close();
+        return false;
+    }
+
+    blocks_ = header.blocks;
+    players_ = header.players;
+    record_size_ = header.record_size;
+    count_ = header.count;
+    records_ = file_.data() + header_size;
+    index_ = file_.data() + header.index_offset;
+
+    return true;
+}
+
+void PositionStore::close() {
+    file_.close();
+    count_ = 0;
+    records_ = nullptr;
+    index_ = nullptr;
+}
+
+std::uint64_t PositionStore::size() const {
+    return count_;
+}
+
+int PositionStore::get_board_size() const {
+    return blocks_;
+}
+
+int PositionStore::get_players() const {
+    return players_;
+}
+
+PositionView PositionStore::operator[](std::uint64_t index) const {
+    assert(index < count_);
+    return PositionView(records_ + index * record_size_, blocks_, players_);
+}
+
+std::int64_t PositionStore::find(std::uint64_t key) const {
+    const std::uint64_t entry = find_first_key(index_, count_, sizeof(IndexEntry), key);
+
+    if (entry == count_ || get_index_entry(entry).key != key) {
+        return -1;
+    }
+
+    return get_index_entry(entry).record;
+}
+
+PositionStore::iterator PositionStore::begin() const {
+    return iterator(this, 0);
+}
+
+PositionStore::iterator PositionStore::end() const {
+    return iterator(this, count_);
+}
+
+PositionStore::IndexEntry PositionStore::get_index_entry(std::uint64_t entry) const {
+    return load_unaligned<IndexEntry>(index_ + entry * sizeof(IndexEntry));
+}
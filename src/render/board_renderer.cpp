@@ -0,0 +1,283 @@
+#define GL_GLEXT_PROTOTYPES
+#include <GL/gl.h>
+#include <GL/glext.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "render/board_renderer.hpp"
+
+Color get_player_color(int id) {
+    Color player_color;
+
+    if (id == 0) {
+        player_color = Color{1.0f, 0.0f, 0.0f, 1.0f};
+    } else {
+        player_color = Color{0.0f, 0.0f, 1.0f, 1.0f};
+    }
+
+    return player_color;
+}
+
+BoardRenderer::BoardRenderer(int blocks, float block_width) {
+    blocks_ = blocks;
+    block_width_ = block_width;
+
+    GLuint buffers[3];
+    glGenBuffers(3, buffers);
+    board_buffer_ = buffers[0];
+    cursor_buffer_ = buffers[1];
+    line_buffer_ = buffers[2];
+
+    board_vertex_count_ = 0;
+    cursor_vertex_count_ = 0;
+    board_ = nullptr;
+    board_generation_ = 0;
+    full_redraws_ = 2;
+
+    // The lines of the board never change, so they're only built once
+    const int lines = blocks + 1;
+    const float top = block_width * blocks / 2;
+    const float bottom = -top;
+    const Color line_color{0.0f, 0.0f, 0.0f, 1.0f};
+
+    for (int i = 0; i < lines; i++) {
+        const float horizontal_pos = bottom + block_width * i;
+        vertices_.push_back(Vertex{horizontal_pos, top, line_color});
+        vertices_.push_back(Vertex{horizontal_pos, bottom, line_color});
+
+        // Horz
+        vertices_.push_back(Vertex{top, horizontal_pos, line_color});
+        vertices_.push_back(Vertex{bottom, horizontal_pos, line_color});
+    }
+
+    line_vertex_count_ = vertices_.size();
+
+    glBindBuffer(GL_ARRAY_BUFFER, line_buffer_);
+    glBufferData(GL_ARRAY_BUFFER, vertices_.size() * sizeof(Vertex), vertices_.data(),
+        GL_STATIC_DRAW);
+
+    // The cursor is at most two triangles, so its buffer is made big enough once
+    // and then overwritten.
+    glBindBuffer(GL_ARRAY_BUFFER, cursor_buffer_);
+    glBufferData(GL_ARRAY_BUFFER, 6 * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+BoardRenderer::~BoardRenderer() {
+    const GLuint buffers[3] = {board_buffer_, cursor_buffer_, line_buffer_};
+    glDeleteBuffers(3, buffers);
+}
+
+void BoardRenderer::set_board(const Board& board) {
+
+    // A board with the same generation still has the same pieces
+    if (&board == board_ && board.get_generation() == board_generation_) {
+        return;
+    }
+
+    vertices_.clear();
+    add_board_vertices(vertices_, board, block_width_);
+    board_vertex_count_ = vertices_.size();
+
+    glBindBuffer(GL_ARRAY_BUFFER, board_buffer_);
+    glBufferData(GL_ARRAY_BUFFER, vertices_.size() * sizeof(Vertex), vertices_.data(),
+        GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    board_ = &board;
+    board_generation_ = board.get_generation();
+    redraw_all();
+}
+
+void BoardRenderer::set_cursor(const Game::Cursor& cursor) {
+    const CursorState state{true, Game::Placement{cursor.x, cursor.y, cursor.piece->get_shape()},
+        cursor.player_id};
+
+    if (state == cursor_) {
+        return;
+    }
+
+    Color color = get_player_color(cursor.player_id);
+    // Lighten colours and add transparency
+    color.r += 0.2f;
+    color.g += 0.2f;
+    color.b += 0.2f;
+    color.a = 0.8f;
+
+    vertices_.clear();
+    add_shape_vertices(vertices_, state.placement.shape, state.placement.x, state.placement.y,
+        blocks_, block_width_, color);
+    cursor_vertex_count_ = vertices_.size();
+
+    glBindBuffer(GL_ARRAY_BUFFER, cursor_buffer_);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices_.size() * sizeof(Vertex), vertices_.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    cursor_ = state;
+}
+
+void BoardRenderer::hide_cursor() {
+    cursor_.is_shown = false;
+}
+
+void BoardRenderer::redraw_all() {
+    full_redraws_ = 2;
+}
+
+bool BoardRenderer::draw_changes() {
+    if (full_redraws_ > 0) {
+        draw();
+        --full_redraws_;
+    } else if (cursor_ != drawn_cursors_[0] || cursor_ != drawn_cursors_[1]) {
+
+        // Draw over wherever the cursor is in the back buffer and wherever it
+        // is now. Everything else in the back buffer is the same.
+        glEnable(GL_SCISSOR_TEST);
+
+        for (const CursorState* state : {&drawn_cursors_[0], &drawn_cursors_[1], &cursor_}) {
+            if (state->is_shown) {
+                scissor_slot(state->placement.x, state->placement.y);
+                draw();
+            }
+        }
+
+        glDisable(GL_SCISSOR_TEST);
+    } else {
+        return false;
+    }
+
+    drawn_cursors_[1] = drawn_cursors_[0];
+    drawn_cursors_[0] = cursor_;
+
+    return true;
+}
+
+void BoardRenderer::draw() const {
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+
+    draw_buffer(board_buffer_, board_vertex_count_, GL_TRIANGLES);
+
+    if (cursor_.is_shown) {
+        draw_buffer(cursor_buffer_, cursor_vertex_count_, GL_TRIANGLES);
+    }
+
+    draw_buffer(line_buffer_, line_vertex_count_, GL_LINES);
+
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void BoardRenderer::draw_buffer(unsigned int buffer, int vertex_count, unsigned int mode) const {
+    if (vertex_count == 0) {
+        return;
+    }
+
+    // With a buffer bound, the pointers are offsets into the buffer
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glVertexPointer(2, GL_FLOAT, sizeof(Vertex),
+        reinterpret_cast<const void*>(offsetof(Vertex, x)));
+    glColorPointer(4, GL_FLOAT, sizeof(Vertex),
+        reinterpret_cast<const void*>(offsetof(Vertex, color)));
+    glDrawArrays(mode, 0, vertex_count);
+}
+
+void BoardRenderer::scissor_slot(int x, int y) const {
+    GLfloat model_view[16];
+    GLfloat projection[16];
+    GLint viewport[4];
+
+    glGetFloatv(GL_MODELVIEW_MATRIX, model_view);
+    glGetFloatv(GL_PROJECTION_MATRIX, projection);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    // Converts world space coordinates to window coordinates. The matrices are
+    // stored column by column.
+    auto to_window = [&](float world_x, float world_y, float& window_x, float& window_y) {
+        float eye[4];
+
+        for (int i = 0; i < 4; ++i) {
+            eye[i] = model_view[i] * world_x + model_view[4 + i] * world_y + model_view[12 + i];
+        }
+
+        float clip[4];
+
+        for (int i = 0; i < 4; ++i) {
+            clip[i] = projection[i] * eye[0] + projection[4 + i] * eye[1]
+                + projection[8 + i] * eye[2] + projection[12 + i] * eye[3];
+        }
+
+        window_x = viewport[0] + (clip[0] / clip[3] + 1.0f) / 2.0f * viewport[2];
+        window_y = viewport[1] + (clip[1] / clip[3] + 1.0f) / 2.0f * viewport[3];
+    };
+
+    const float left = (x - blocks_ / 2.0f) * block_width_;
+    const float top = (blocks_ / 2.0f - y) * block_width_;
+
+    float x0, y0, x1, y1;
+    to_window(left, top, x0, y0);
+    to_window(left + block_width_, top - block_width_, x1, y1);
+
+    // Grow the slot by a pixel on each side to cover the lines around it
+    const int min_x = std::floor(std::min(x0, x1)) - 1;
+    const int min_y = std::floor(std::min(y0, y1)) - 1;
+    const int max_x = std::ceil(std::max(x0, x1)) + 1;
+    const int max_y = std::ceil(std::max(y0, y1)) + 1;
+
+    glScissor(min_x, min_y, max_x - min_x, max_y - min_y);
+}
+
+void BoardRenderer::add_shape_vertices(std::vector<Vertex>& vertices, shape_id shape, int x,
+    int y, int blocks, float block_width, Color color) {
+    const ShapeInfo& info = get_shape_info(shape);
+    const float center_offset = blocks / 2.0f;
+
+    // Quads are split into the triangles of their first three points and of
+    // their last two points and first point.
+    const int triangle_corners[2][3] = {{0, 1, 2}, {2, 3, 0}};
+    const int triangles = info.point_count == 4 ? 2 : 1;
+
+    for (int triangle = 0; triangle < triangles; ++triangle) {
+        for (int corner : triangle_corners[triangle]) {
+
+            // Pieces are centered at 0,0 and have a default width of 2
+            const Piece::Point p = info.points[corner];
+
+            // Need to scale down by half
+            const float rescaled_x = (p.x + 1.0f) / 2.0f;
+            const float rescaled_y = (p.y + 1.0f) / 2.0f;
+
+            // Need to offset by -1 for y due to 0,0 being top left for board
+            // where top left of interface is -blocks/2 * board_width, blocks/2 * board_width
+            vertices.push_back(Vertex{(rescaled_x - center_offset + x) * block_width,
+                (rescaled_y + center_offset - y - 1) * block_width, color});
+        }
+    }
+}
+
+void BoardRenderer::add_board_vertices(std::vector<Vertex>& vertices, const Board& board,
+    float block_width) {
+    const int blocks = board.get_size();
+
+    for (int y = 0; y < blocks; ++y) {
+        for (int x = 0; x < blocks; ++x) {
+            const Board::slot_contents slot = board.get_slot(x, y);
+
+            if (slot.first) {
+                add_shape_vertices(vertices, slot.first.shape, x, y, blocks, block_width,
+                    get_player_color(slot.first.owner));
+            }
+
+            if (slot.second) {
+                add_shape_vertices(vertices, slot.second.shape, x, y, blocks, block_width,
+                    get_player_color(slot.second.owner));
+            }
+        }
+    }
+}
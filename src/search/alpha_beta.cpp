@@ -0,0 +1,432 @@
+#include <algorithm>
+#include <cassert>
+
+#include "search/alpha_beta.hpp"
+#include "components/shapes.hpp"
+#include "util/hash.hpp"
+
+namespace {
+
+    // Scores are from the point of view of the searching actor and are kept
+    // within what the transposition table can store.
+    constexpr int infinity = TranspositionTable::max_score;
+
+    // A half square placed is worth more than any difference in the number of
+    // valid placements, which only breaks ties between equal scores.
+    constexpr int half_square_score = 1024;
+
+    // Nodes are counted locally and added to the shared count in batches.
+    constexpr std::uint64_t node_batch = 1024;
+
+    // Scores depend on which actor is searching, so positions searched for
+    // different actors can't share entries.
+    std::uint64_t searcher_key(int actor) {
+        return mix_bits((std::uint64_t{1} << 62) | actor);
+    }
+}
+
+class AlphaBetaSearch::Searcher {
+
+    public:
+        Searcher(AlphaBetaSearch& search, int index);
+
+        // Runs iterative deepening until the search stops.
+        void run(const Board& board, int num_actors, int actor, int half_squares_placed);
+
+    private:
+        // Everything known about the position at a ply apart from the board.
+        struct Ply {
+            int actor;
+            int half_squares_placed;
+
+            // The number of actors in a row that couldn't place anything.
+            int passes;
+
+            std::uint64_t key;
+
+            // Buffer the valid placements are generated into, which grows as needed.
+            std::vector<Game::Placement> placements;
+        };
+
+        AlphaBetaSearch& search_;
+        const int index_;
+
+        int num_actors_;
+        int searching_actor_;
+
+        // The board at each ply, which are reused between searches.
+        std::vector<Board> boards_;
+        std::vector<Ply> plies_;
+
+        // The best line of placements found from each ply.
+        std::vector<std::vector<Game::Placement>> lines_;
+        std::vector<int> line_lengths_;
+
+        std::uint64_t nodes_;
+        int completed_depth_;
+        bool is_aborted_;
+        bool reached_horizon_;
+
+        int alpha_beta(int depth, int ply, int alpha, int beta);
+
+        // Scores a position for the searching actor.
+        int evaluate(const Board& board) const;
+
+        // Counts a node and checks if the search should stop. Returns true if
+        // the current iteration has to be abandoned.
+        bool poll();
+
+        // Sets the board of the next ply to a copy of the board of `ply`.
+        Board& copy_board_to_next_ply(int ply);
+
+        void record_best_turn(int score, int depth);
+};
+
+AlphaBetaSearch::Searcher::Searcher(AlphaBetaSearch& search, int index)
+    : search_(search), index_(index) {
+    const int max_depth = search_.limits_.max_depth;
+
+    // Boards are only added when a ply is first reached, so the space for
+    // them is reserved to keep references to earlier plies valid.
+    boards_.reserve(max_depth + 2);
+    plies_.resize(max_depth + 2);
+    lines_.assign(max_depth + 2, std::vector<Game::Placement>(max_depth + 2));
+    line_lengths_.resize(max_depth + 2);
+}
+
+void AlphaBetaSearch::Searcher::run(const Board& board, int num_actors, int actor,
+    int half_squares_placed) {
+    num_actors_ = num_actors;
+    searching_actor_ = actor;
+    nodes_ = 0;
+    completed_depth_ = 0;
+
+    // Boards from a search on a different size of board can't be reused
+    if (!boards_.empty() && boards_[0].get_size() != board.get_size()) {
+        boards_.clear();
+    }
+
+    if (boards_.empty()) {
+        boards_.push_back(board);
+    } else {
+        boards_[0] = board;
+    }
+
+    Ply& root = plies_[0];
+    root.actor = actor;
+    root.half_squares_placed = half_squares_placed;
+    root.passes = 0;
+    root.key = board.get_key() ^ Game::get_turn_key(actor, half_squares_placed)
+        ^ searcher_key(actor);
+
+    // Half of the helper threads search a ply deeper than the main thread so
+    // the threads spread out over more of the tree.
+    const int first_depth = index_ % 2 == 1 ? 2 : 1;
+
+    for (int depth = first_depth; depth <= search_.limits_.max_depth; ++depth) {
+        is_aborted_ = false;
+        reached_horizon_ = false;
+
+        const int score = alpha_beta(depth, 0, -infinity, infinity);
+
+        if (is_aborted_) {
+            break;
+        }
+
+        completed_depth_ = depth;
+
+        if (index_ == 0) {
+            record_best_turn(score, depth);
+        }
+
+        // Searching deeper finds nothing new once every line ends the game
+        if (!reached_horizon_ || search_.is_stopping_.load(std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    search_.nodes_.fetch_add(nodes_ % node_batch, std::memory_order_relaxed);
+
+    // The helpers only help the main thread, so they stop along with it
+    if (index_ == 0) {
+        search_.is_stopping_.store(true, std::memory_order_relaxed);
+    }
+}
+
+int AlphaBetaSearch::Searcher::alpha_beta(int depth, int ply, int alpha, int beta) {
+    Ply& state = plies_[ply];
+    const Board& board = boards_[ply];
+    line_lengths_[ply] = 0;
+
+    if (poll()) {
+        is_aborted_ = true;
+        return 0;
+    }
+
+    if (depth == 0) {
+        reached_horizon_ = true;
+        return evaluate(board);
+    }
+
+    const int alpha_start = alpha;
+    const int beta_start = beta;
+
+    // Use what was found the last time this position was searched
+    TranspositionTable::Entry entry;
+    const bool has_entry = search_.table_.probe(state.key, entry);
+
+    if (has_entry && ply > 0 && entry.depth >= depth) {
+        if (entry.type == TranspositionTable::bound::exact) {
+            return entry.score;
+        } else if (entry.type == TranspositionTable::bound::lower) {
+            alpha = std::max(alpha, entry.score);
+        } else {
+            beta = std::min(beta, entry.score);
+        }
+
+        if (alpha >= beta) {
+            return entry.score;
+        }
+    }
+
+    const int count = Game::generate_placements(state.actor, state.half_squares_placed,
+        board, state.placements);
+
+    Ply& next = plies_[ply + 1];
+
+    // The actor can't place anything, so their turn passes to the next actor
+    if (count == 0) {
+        if (state.passes + 1 == num_actors_) {
+            return evaluate(board);
+        }
+
+        copy_board_to_next_ply(ply);
+        next.actor = (state.actor + 1) % num_actors_;
+        next.half_squares_placed = 0;
+        next.passes = state.passes + 1;
+        next.key = state.key ^ Game::get_turn_key(state.actor, state.half_squares_placed)
+            ^ Game::get_turn_key(next.actor, 0);
+
+        return alpha_beta(depth - 1, ply + 1, alpha, beta);
+    }
+
+    // Try the best placement from before first, and have each helper thread
+    // try the rest in a different order.
+    Game::Placement* placements = state.placements.data();
+    int first_unordered = 0;
+
+    if (has_entry && entry.has_move) {
+        for (int i = 0; i < count; ++i) {
+            const Game::Placement& placement = placements[i];
+
+            if (placement.x == entry.move.x && placement.y == entry.move.y
+                && placement.shape == entry.move.shape) {
+                std::swap(placements[0], placements[i]);
+                first_unordered = 1;
+                break;
+            }
+        }
+    }
+
+    if (index_ > 0 && count - first_unordered > 1) {
+        const int offset = (index_ * 7 + ply) % (count - first_unordered);
+        std::rotate(placements + first_unordered, placements + first_unordered + offset,
+            placements + count);
+    }
+
+    const bool is_maximizing = state.actor == searching_actor_;
+    int best_score = is_maximizing ? -infinity : infinity;
+    Game::Placement best_placement = placements[0];
+
+    for (int i = 0; i < count; ++i) {
+        const Game::Placement placement = placements[i];
+
+        Board& next_board = copy_board_to_next_ply(ply);
+        next_board.place_piece(state.actor, placement.shape, placement.x, placement.y);
+
+        // The turn moves on once a square or two halves have been placed
+        next.half_squares_placed = placement.shape == square_shape ? 2 : state.half_squares_placed + 1;
+        next.actor = state.actor;
+
+        if (next.half_squares_placed == 2) {
+            next.half_squares_placed = 0;
+            next.actor = (state.actor + 1) % num_actors_;
+        }
+
+        next.passes = 0;
+        next.key = next_board.get_key() ^ Game::get_turn_key(next.actor, next.half_squares_placed)
+            ^ searcher_key(searching_actor_);
+
+        const int score = alpha_beta(depth - 1, ply + 1, alpha, beta);
+
+        if (is_aborted_) {
+            return 0;
+        }
+
+        if (is_maximizing ? score > best_score : score < best_score) {
+            best_score = score;
+            best_placement = placement;
+
+            // The best line from here is this placement then the best line after it
+            lines_[ply][0] = placement;
+            std::copy_n(lines_[ply + 1].begin(), line_lengths_[ply + 1], lines_[ply].begin() + 1);
+            line_lengths_[ply] = line_lengths_[ply + 1] + 1;
+        }
+
+        if (is_maximizing) {
+            alpha = std::max(alpha, best_score);
+        } else {
+            beta = std::min(beta, best_score);
+        }
+
+        if (alpha >= beta) {
+            break;
+        }
+    }
+
+    TranspositionTable::Entry result;
+    result.score = best_score;
+    result.depth = depth;
+    result.has_move = true;
+    result.move = best_placement;
+
+    if (best_score <= alpha_start) {
+        result.type = TranspositionTable::bound::upper;
+    } else if (best_score >= beta_start) {
+        result.type = TranspositionTable::bound::lower;
+    } else {
+        result.type = TranspositionTable::bound::exact;
+    }
+
+    search_.table_.store(state.key, result);
+
+    return best_score;
+}
+
+int AlphaBetaSearch::Searcher::evaluate(const Board& board) const {
+    int own_score = 0;
+    int best_other_score = -infinity;
+
+    for (int actor = 0; actor < num_actors_; ++actor) {
+        const int half_squares = static_cast<int>(board.get_score(actor) * 2);
+        const int score = half_squares * half_square_score
+            + Game::count_placements(actor, 0, board);
+
+        if (actor == searching_actor_) {
+            own_score = score;
+        } else {
+            best_other_score = std::max(best_other_score, score);
+        }
+    }
+
+    return std::clamp(own_score - best_other_score, -infinity + 1, infinity - 1);
+}
+
+bool AlphaBetaSearch::Searcher::poll() {
+    if (++nodes_ % node_batch == 0) {
+        const Limits& limits = search_.limits_;
+        const std::uint64_t nodes = search_.nodes_.fetch_add(node_batch,
+            std::memory_order_relaxed) + node_batch;
+
+        const bool is_out_of_nodes = limits.nodes > 0 && nodes >= limits.nodes;
+        const bool is_out_of_time = limits.time.count() > 0
+            && std::chrono::steady_clock::now() >= search_.deadline_;
+
+        if (is_out_of_nodes || is_out_of_time
+            || search_.is_cancelled_.load(std::memory_order_relaxed)) {
+            search_.is_stopping_.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    // The main thread always finishes its first iteration so there's a turn to play
+    if (index_ == 0 && completed_depth_ == 0) {
+        return false;
+    }
+
+    return search_.is_stopping_.load(std::memory_order_relaxed);
+}
+
+Board& AlphaBetaSearch::Searcher::copy_board_to_next_ply(int ply) {
+    if (static_cast<int>(boards_.size()) == ply + 1) {
+        boards_.push_back(boards_[ply]);
+    } else {
+        boards_[ply + 1] = boards_[ply];
+    }
+
+    return boards_[ply + 1];
+}
+
+void AlphaBetaSearch::Searcher::record_best_turn(int score, int depth) {
+    Turn& turn = search_.best_turn_;
+    turn.score = score;
+    turn.depth = depth;
+    turn.count = 0;
+
+    if (line_lengths_[0] == 0) {
+        return;
+    }
+
+    turn.placements[turn.count++] = lines_[0][0];
+
+    // The second placement of the line is the rest of the turn if the first
+    // placement was a half
+    const Ply& root = plies_[0];
+
+    if (line_lengths_[0] > 1 && root.half_squares_placed == 0
+        && lines_[0][0].shape != square_shape) {
+        turn.placements[turn.count++] = lines_[0][1];
+    }
+}
+
+AlphaBetaSearch::AlphaBetaSearch(const Limits& limits)
+    : limits_(limits), table_(limits.table_megabytes) {
+    assert(limits_.threads >= 1);
+    assert(limits_.max_depth >= 1 && limits_.max_depth <= 255);
+
+    is_stopping_ = false;
+    is_cancelled_ = false;
+    nodes_ = 0;
+
+    if (limits_.threads > 1) {
+        pool_ = std::make_unique<ThreadPool>(limits_.threads - 1);
+    }
+
+    for (int i = 0; i < limits_.threads; ++i) {
+        searchers_.push_back(std::make_unique<Searcher>(*this, i));
+    }
+}
+
+AlphaBetaSearch::~AlphaBetaSearch() = default;
+
+AlphaBetaSearch::Turn AlphaBetaSearch::search(const Board& board, int num_actors, int actor,
+    int half_squares_placed) {
+    best_turn_ = Turn{};
+
+    // Nothing to search for if there is nothing to place
+    if (Game::count_placements(actor, half_squares_placed, board) == 0) {
+        return best_turn_;
+    }
+
+    is_stopping_ = false;
+    nodes_ = 0;
+    deadline_ = std::chrono::steady_clock::now() + limits_.time;
+
+    auto run_searcher = [&](int i) {
+        searchers_[i]->run(board, num_actors, actor, half_squares_placed);
+    };
+
+    if (pool_) {
+        pool_->run(limits_.threads, run_searcher);
+    } else {
+        run_searcher(0);
+    }
+
+    Turn turn = best_turn_;
+    turn.nodes = nodes_;
+    return turn;
+}
+
+void AlphaBetaSearch::cancel() {
+    is_cancelled_ = true;
+    is_stopping_ = true;
+}
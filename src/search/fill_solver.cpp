@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <cassert>
+
+#include "search/fill_solver.hpp"
+
+FillSolver::FillSolver(std::size_t table_megabytes) : table_(table_megabytes), nodes_(0) {}
+
+bool FillSolver::next_placement(const Board& board, int id, Frame& frame,
+    Game::Placement& placement) {
+    const int size = board.get_size();
+
+    for (; frame.next_slot < size * size; ++frame.next_slot, frame.next_shape = square_shape) {
+        const int x = frame.next_slot % size;
+        const int y = frame.next_slot / size;
+
+        const Board::slot_contents slot = board.get_slot(x, y);
+        int free_halves;
+        const std::uint16_t free_points = ReachableRegion::get_free_points(slot, free_halves);
+
+        if (!free_points) {
+            continue;
+        }
+
+        const std::uint16_t touching = board.get_touching_points(id, x, y) & free_points;
+
+        if (!touching) {
+            continue;
+        }
+
+        // Only the partner of the first half fits in the rest of the slot
+        shape_id first = frame.next_shape;
+        shape_id last = shape_count - 1;
+
+        if (slot.first) {
+            const shape_id partner = get_shape_info(slot.first.shape).partner;
+            first = std::max(first, partner);
+            last = partner;
+        }
+
+        for (shape_id shape = first; shape <= last; ++shape) {
+            if (get_shape_info(shape).point_mask & touching) {
+                placement = Game::Placement{x, y, shape};
+                frame.next_shape = shape + 1;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+int FillSolver::get_upper_bound(const Board& board, int id) {
+    return region_.compute(board, id);
+}
+
+int FillSolver::solve(Board& board, int id) {
+    assert(id >= 0 && id < board.get_players());
+
+    nodes_ = 0;
+
+    const int most_halves = get_upper_bound(board, id);
+
+    if (most_halves == 0) {
+        return 0;
+    }
+
+    // Every placement places at least a half, so no fill is deeper than the bound
+    const std::size_t frames = most_halves + 1;
+
+    if (boards_.size() < frames) {
+        boards_.resize(frames, board);
+        frames_.resize(frames);
+    }
+
+    // Positions are stored for each actor, since they fill the same board differently
+    const std::uint64_t actor_key = Game::get_turn_key(id, 0);
+
+    boards_[0] = board;
+    frames_[0] = Frame{0, square_shape, 0, false};
+
+    int best = -1;
+    int depth = 0;
+
+    while (depth >= 0) {
+        Frame& frame = frames_[depth];
+        const Board& current = boards_[depth];
+        Game::Placement placement;
+
+        if (!next_placement(current, id, frame, placement)) {
+            if (!frame.has_placed) {
+                // A board with nothing left to place is a complete fill
+                if (frame.placed > best) {
+                    best = frame.placed;
+                    best_board_ = current;
+
+                    if (best == most_halves) {
+                        break;
+                    }
+                }
+            } else {
+                // Nothing placed on the board does better than the best fill
+                table_.store(current.get_key() ^ actor_key, TranspositionTable::Entry{
+                    std::max(best - frame.placed, 0), 0, TranspositionTable::bound::upper, false, {}});
+            }
+
+            --depth;
+            continue;
+        }
+
+        frame.has_placed = true;
+
+        Board& child = boards_[depth + 1];
+        child = current;
+        child.place_piece(id, placement.shape, placement.x, placement.y);
+        ++nodes_;
+
+        const int placed = frame.placed + (placement.shape == square_shape ? 2 : 1);
+
+        // Only cut off boards once there's a fill to beat
+        if (best >= 0) {
+            TranspositionTable::Entry entry;
+
+            if (table_.probe(child.get_key() ^ actor_key, entry) && placed + entry.score <= best) {
+                continue;
+            }
+
+            if (placed + get_upper_bound(child, id) <= best) {
+                continue;
+            }
+        }
+
+        frames_[depth + 1] = Frame{0, square_shape, placed, false};
+        ++depth;
+    }
+
+    board = best_board_;
+    return best;
+}
+
+std::uint64_t FillSolver::get_nodes() const {
+    return nodes_;
+}
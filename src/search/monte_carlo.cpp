@@ -0,0 +1,417 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <random>
+
+#include "search/monte_carlo.hpp"
+#include "components/shapes.hpp"
+
+class MonteCarloSearch::Worker {
+
+    public:
+        Worker(MonteCarloSearch& search, int index);
+
+        // Runs playouts until the search stops.
+        void run(const Board& board, int num_actors, int actor, int half_squares_placed);
+
+    private:
+        MonteCarloSearch& search_;
+        const int index_;
+
+        std::mt19937_64 generator_;
+        int num_actors_;
+
+        // The position of the current playout, which is reused between playouts
+        // so they don't allocate.
+        Board board_;
+        int actor_;
+        int half_squares_placed_;
+
+        // Buffer the valid placements are generated into.
+        std::vector<Game::Placement> placements_;
+
+        // The nodes the current playout went through.
+        std::vector<int> path_;
+
+        // What each actor gets for the result of the current playout.
+        std::vector<int> rewards_;
+
+        // Goes down the tree from the root, expanding one node, then plays out
+        // the rest of the game and updates the nodes that were visited.
+        void run_playout(const Board& board, int actor, int half_squares_placed);
+
+        // Adds the children of a node for every valid placement from the current
+        // position. Returns the new state of the node.
+        node_state expand(int node);
+
+        // Picks the child of a node with the best upper confidence bound.
+        int select_child(int node) const;
+
+        // Adds a node to the path and makes its placement.
+        void visit(int node);
+
+        void place(const Game::Placement& placement);
+
+        // Places random placements until no actor can place anything.
+        void play_randomly();
+
+        void score_result();
+
+        void back_propagate();
+};
+
+MonteCarloSearch::Worker::Worker(MonteCarloSearch& search, int index)
+    : search_(search), index_(index) {}
+
+void MonteCarloSearch::Worker::run(const Board& board, int num_actors, int actor,
+    int half_squares_placed) {
+    const Limits& limits = search_.limits_;
+
+    // Every search with the same seed plays the same playouts on a thread
+    generator_.seed(limits.seed + index_);
+    num_actors_ = num_actors;
+    rewards_.resize(num_actors);
+
+    for (std::uint64_t playouts = 1; ; ++playouts) {
+        run_playout(board, actor, half_squares_placed);
+
+        const std::uint64_t total = search_.playouts_.fetch_add(1, std::memory_order_relaxed) + 1;
+
+        const bool is_out_of_playouts = limits.playouts > 0 && total >= limits.playouts;
+
+        // Reading the clock takes about as long as a few placements, so only
+        // check it every few playouts.
+        const bool is_out_of_time = limits.time.count() > 0 && playouts % 16 == 0
+            && std::chrono::steady_clock::now() >= search_.deadline_;
+
+        if (is_out_of_playouts || is_out_of_time
+            || search_.is_cancelled_.load(std::memory_order_relaxed)) {
+            search_.is_stopping_.store(true, std::memory_order_relaxed);
+        }
+
+        if (search_.is_stopping_.load(std::memory_order_relaxed)) {
+            break;
+        }
+    }
+}
+
+void MonteCarloSearch::Worker::run_playout(const Board& board, int actor,
+    int half_squares_placed) {
+    board_ = board;
+    actor_ = actor;
+    half_squares_placed_ = half_squares_placed;
+
+    path_.clear();
+    visit(0);
+
+    int node = 0;
+
+    while (true) {
+        Node& current = search_.nodes_[node];
+        node_state state = current.state.load(std::memory_order_acquire);
+        bool is_new = false;
+
+        // Only the thread that claims a node expands it
+        if (state == unexpanded) {
+            if (current.state.compare_exchange_strong(state, expanding,
+                std::memory_order_acquire)) {
+                state = expand(node);
+                is_new = true;
+            }
+        }
+
+        if (state != expanded || current.child_count == 0) {
+            break;
+        }
+
+        node = select_child(node);
+        visit(node);
+
+        // Play out from the first child of a new node
+        if (is_new) {
+            break;
+        }
+    }
+
+    play_randomly();
+    score_result();
+    back_propagate();
+}
+
+MonteCarloSearch::node_state MonteCarloSearch::Worker::expand(int node) {
+    Node& parent = search_.nodes_[node];
+
+    // Actors that can't place anything pass their turn
+    int actor = actor_;
+    int count = Game::generate_placements(actor, half_squares_placed_, board_, placements_);
+
+    for (int passes = 1; count == 0 && passes < num_actors_; ++passes) {
+        actor = (actor + 1) % num_actors_;
+        count = Game::generate_placements(actor, 0, board_, placements_);
+    }
+
+    int first_child = 0;
+
+    if (count > 0) {
+        // Only take the nodes if they all fit, so the next node never grows
+        // past the end of the nodes no matter how many leaves run out
+        first_child = search_.next_node_.load(std::memory_order_relaxed);
+
+        do {
+            if (count > search_.limits_.max_nodes - first_child) {
+                parent.state.store(out_of_nodes, std::memory_order_release);
+                return out_of_nodes;
+            }
+        } while (!search_.next_node_.compare_exchange_weak(first_child, first_child + count,
+            std::memory_order_relaxed));
+
+        for (int i = 0; i < count; ++i) {
+            Node& child = search_.nodes_[first_child + i];
+            child.placement = placements_[i];
+            child.actor = actor;
+            child.visits.store(0, std::memory_order_relaxed);
+            child.reward.store(0, std::memory_order_relaxed);
+            child.first_child = 0;
+            child.child_count = 0;
+            child.state.store(unexpanded, std::memory_order_relaxed);
+        }
+    }
+
+    // Publish the children to the other threads
+    parent.first_child = first_child;
+    parent.child_count = count;
+    parent.state.store(expanded, std::memory_order_release);
+
+    return expanded;
+}
+
+int MonteCarloSearch::Worker::select_child(int node) const {
+    const Node& parent = search_.nodes_[node];
+    const double log_visits = std::log(std::max(1, parent.visits.load(std::memory_order_relaxed)));
+    const double exploration = search_.limits_.exploration;
+
+    int best_child = parent.first_child;
+    double best_bound = -1;
+
+    for (int child = parent.first_child; child < parent.first_child + parent.child_count; ++child) {
+        const Node& candidate = search_.nodes_[child];
+        const int visits = candidate.visits.load(std::memory_order_relaxed);
+
+        // Try every placement once before trying any of them again
+        if (visits == 0) {
+            return child;
+        }
+
+        const double win_rate = candidate.reward.load(std::memory_order_relaxed) / (2.0 * visits);
+        const double bound = win_rate + exploration * std::sqrt(log_visits / visits);
+
+        if (bound > best_bound) {
+            best_bound = bound;
+            best_child = child;
+        }
+    }
+
+    return best_child;
+}
+
+void MonteCarloSearch::Worker::visit(int node) {
+    Node& visited = search_.nodes_[node];
+
+    // Count the visit as a loss until the playout finishes
+    visited.visits.fetch_add(search_.limits_.virtual_loss, std::memory_order_relaxed);
+    path_.push_back(node);
+
+    if (node == 0) {
+        return;
+    }
+
+    // A different actor means the actors in between passed their turns
+    if (visited.actor != actor_) {
+        actor_ = visited.actor;
+        half_squares_placed_ = 0;
+    }
+
+    place(visited.placement);
+}
+
+void MonteCarloSearch::Worker::place(const Game::Placement& placement) {
+    board_.place_piece(actor_, placement.shape, placement.x, placement.y);
+
+    // The turn moves on once a square or two halves have been placed
+    half_squares_placed_ += placement.shape == square_shape ? 2 : 1;
+
+    if (half_squares_placed_ == 2) {
+        half_squares_placed_ = 0;
+        actor_ = (actor_ + 1) % num_actors_;
+    }
+}
+
+void MonteCarloSearch::Worker::play_randomly() {
+    int passes = 0;
+
+    while (passes < num_actors_) {
+        const int count = Game::generate_placements(actor_, half_squares_placed_, board_,
+            placements_);
+
+        if (count == 0) {
+            ++passes;
+            actor_ = (actor_ + 1) % num_actors_;
+            half_squares_placed_ = 0;
+            continue;
+        }
+
+        passes = 0;
+        place(placements_[generator_() % count]);
+    }
+}
+
+void MonteCarloSearch::Worker::score_result() {
+    float best_score = -1;
+    int winners = 0;
+
+    for (int actor = 0; actor < num_actors_; ++actor) {
+        const float score = board_.get_score(actor);
+
+        if (score > best_score) {
+            best_score = score;
+            winners = 1;
+        } else if (score == best_score) {
+            ++winners;
+        }
+    }
+
+    // A win is worth two and a draw is worth one
+    for (int actor = 0; actor < num_actors_; ++actor) {
+        if (board_.get_score(actor) != best_score) {
+            rewards_[actor] = 0;
+        } else {
+            rewards_[actor] = winners == 1 ? 2 : 1;
+        }
+    }
+}
+
+void MonteCarloSearch::Worker::back_propagate() {
+    const int virtual_loss = search_.limits_.virtual_loss;
+
+    for (int node : path_) {
+        Node& visited = search_.nodes_[node];
+
+        if (visited.actor >= 0) {
+            visited.reward.fetch_add(rewards_[visited.actor], std::memory_order_relaxed);
+        }
+
+        // Replace the virtual losses with the single real visit
+        visited.visits.fetch_sub(virtual_loss - 1, std::memory_order_relaxed);
+    }
+}
+
+MonteCarloSearch::MonteCarloSearch(const Limits& limits) : limits_(limits) {
+    assert(limits_.threads >= 1);
+    assert(limits_.max_nodes >= 1);
+    assert(limits_.virtual_loss >= 1);
+
+    nodes_ = std::make_unique<Node[]>(limits_.max_nodes);
+    next_node_ = 0;
+    is_stopping_ = false;
+    is_cancelled_ = false;
+    playouts_ = 0;
+
+    if (limits_.threads > 1) {
+        pool_ = std::make_unique<ThreadPool>(limits_.threads - 1);
+    }
+
+    for (int i = 0; i < limits_.threads; ++i) {
+        workers_.push_back(std::make_unique<Worker>(*this, i));
+    }
+}
+
+MonteCarloSearch::~MonteCarloSearch() = default;
+
+MonteCarloSearch::Turn MonteCarloSearch::search(const Board& board, int num_actors, int actor,
+    int half_squares_placed) {
+    Turn turn;
+
+    // Nothing to search for if there is nothing to place
+    if (Game::count_placements(actor, half_squares_placed, board) == 0) {
+        return turn;
+    }
+
+    // Start a new tree from just the root
+    Node& root = nodes_[0];
+    root.actor = -1;
+    root.visits = 0;
+    root.reward = 0;
+    root.first_child = 0;
+    root.child_count = 0;
+    root.state = unexpanded;
+    next_node_ = 1;
+
+    is_stopping_ = false;
+    playouts_ = 0;
+    deadline_ = std::chrono::steady_clock::now() + limits_.time;
+
+    auto run_worker = [&](int i) {
+        workers_[i]->run(board, num_actors, actor, half_squares_placed);
+    };
+
+    if (pool_) {
+        pool_->run(limits_.threads, run_worker);
+    } else {
+        run_worker(0);
+    }
+
+    turn.playouts = playouts_;
+
+    const int first = get_most_visited_child(0);
+
+    // Without space for any nodes, fall back to any valid placement
+    if (first < 0) {
+        std::vector<Game::Placement> placements;
+        Game::generate_placements(actor, half_squares_placed, board, placements);
+        turn.placements[turn.count++] = placements[0];
+        return turn;
+    }
+
+    const Node& first_node = nodes_[first];
+    turn.placements[turn.count++] = first_node.placement;
+    turn.win_rate = first_node.reward / (2.0 * std::max(1, first_node.visits.load()));
+
+    // The rest of the turn is the most visited placement after a half, as long as
+    // the actor could place another half
+    if (half_squares_placed == 0 && first_node.placement.shape != square_shape) {
+        const int second = get_most_visited_child(first);
+
+        if (second >= 0 && nodes_[second].actor == actor) {
+            turn.placements[turn.count++] = nodes_[second].placement;
+        }
+    }
+
+    return turn;
+}
+
+void MonteCarloSearch::cancel() {
+    is_cancelled_ = true;
+    is_stopping_ = true;
+}
+
+int MonteCarloSearch::get_most_visited_child(int node) const {
+    const Node& parent = nodes_[node];
+
+    if (parent.state.load() != expanded) {
+        return -1;
+    }
+
+    int best_child = -1;
+    int best_visits = 0;
+
+    for (int child = parent.first_child; child < parent.first_child + parent.child_count; ++child) {
+        const int visits = nodes_[child].visits.load();
+
+        if (visits > best_visits) {
+            best_visits = visits;
+            best_child = child;
+        }
+    }
+
+    return best_child;
+}
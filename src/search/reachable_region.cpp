@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cassert>
+
+#include "search/reachable_region.hpp"
+#include "components/shapes.hpp"
+
+// Every point of a slot except its center, which is every point the pieces of
+// an empty slot can have between them.
+static constexpr std::uint16_t side_points = 0x1FF & ~(1 << 4);
+
+// Moves points of a slot to the same points of the slot dx and dy away from it,
+// dropping the points that the other slot doesn't have. The points are in the
+// same order as `ShapeInfo::point_mask`, where rows go down the board like y does.
+static constexpr std::uint16_t move_points(std::uint16_t points, int dx, int dy) {
+    constexpr std::uint16_t left_column = 0b001001001;
+    constexpr std::uint16_t right_column = left_column << 2;
+    constexpr std::uint16_t top_row = 0b111;
+    constexpr std::uint16_t bottom_row = top_row << 6;
+
+    if (dx > 0) {
+        points = (points & right_column) >> 2;
+    } else if (dx < 0) {
+        points = (points & left_column) << 2;
+    }
+
+    if (dy > 0) {
+        points = (points & bottom_row) >> 6;
+    } else if (dy < 0) {
+        points = (points & top_row) << 6;
+    }
+
+    return points;
+}
+
+std::uint16_t ReachableRegion::get_free_points(const Board::slot_contents& slot, int& free_halves) {
+    if (!slot.first) {
+        free_halves = 2;
+        return side_points;
+    }
+
+    if (slot.second || slot.first.shape == square_shape) {
+        free_halves = 0;
+        return 0;
+    }
+
+    free_halves = 1;
+    return get_shape_info(get_shape_info(slot.first.shape).partner).point_mask;
+}
+
+int ReachableRegion::compute(const Board& board, int id) {
+    size_ = board.get_size();
+    slots_.assign((size_ * size_ + 63) / 64, 0);
+    pending_slots_.clear();
+    free_halves_ = 0;
+
+    auto reach = [this](int index, int free_halves) {
+        slots_[index / 64] |= Board::bitboard{1} << (index % 64);
+        pending_slots_.push_back(index);
+        free_halves_ += free_halves;
+    };
+
+    // Start from the slots next to the actor's pieces
+    for (int y = 0; y < size_; ++y) {
+        for (int x = 0; x < size_; ++x) {
+            int free_halves;
+            const std::uint16_t free_points = get_free_points(board.get_slot(x, y), free_halves);
+
+            if (free_points && (free_points & board.get_touching_points(id, x, y))) {
+                reach(y * size_ + x, free_halves);
+            }
+        }
+    }
+
+    while (!pending_slots_.empty()) {
+        const int index = pending_slots_.back();
+        pending_slots_.pop_back();
+
+        const int x = index % size_;
+        const int y = index / size_;
+
+        int free_halves;
+        const std::uint16_t reached_points = get_free_points(board.get_slot(x, y), free_halves);
+
+        for (int h = std::max(y - 1, 0); h < std::min(y + 2, size_); ++h) {
+            for (int w = std::max(x - 1, 0); w < std::min(x + 2, size_); ++w) {
+                if (contains(w, h)) {
+                    continue;
+                }
+
+                const std::uint16_t free_points = get_free_points(board.get_slot(w, h), free_halves);
+
+                if (free_points & move_points(reached_points, w - x, h - y)) {
+                    reach(h * size_ + w, free_halves);
+                }
+            }
+        }
+    }
+
+    return free_halves_;
+}
+
+int ReachableRegion::get_free_halves() const {
+    return free_halves_;
+}
+
+bool ReachableRegion::contains(int x, int y) const {
+    const int index = y * size_ + x;
+    return slots_[index / 64] & (Board::bitboard{1} << (index % 64));
+}
+
+bool ReachableRegion::intersects(const ReachableRegion& other) const {
+    assert(size_ == other.size_);
+
+    for (std::size_t word = 0; word < slots_.size(); ++word) {
+        if (slots_[word] & other.slots_[word]) {
+            return true;
+        }
+    }
+
+    return false;
+}
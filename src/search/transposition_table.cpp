@@ -0,0 +1,106 @@
+#include <cassert>
+
+#include "search/transposition_table.hpp"
+
+// Entries are packed into a word as the score, depth, bound, whether there's a
+// move, then the move's shape, x and y, from the lowest bits up.
+namespace {
+    constexpr int score_bits = 28;
+    constexpr int depth_bits = 8;
+    constexpr int bound_bits = 2;
+    constexpr int shape_bits = 4;
+    constexpr int position_bits = 10;
+
+    constexpr int depth_shift = score_bits;
+    constexpr int bound_shift = depth_shift + depth_bits;
+    constexpr int has_move_shift = bound_shift + bound_bits;
+    constexpr int shape_shift = has_move_shift + 1;
+    constexpr int x_shift = shape_shift + shape_bits;
+    constexpr int y_shift = x_shift + position_bits;
+
+    static_assert(y_shift + position_bits <= 64);
+    static_assert(1 << position_bits >= Board::max_board_size);
+
+    constexpr std::uint64_t field(int bits) {
+        return (std::uint64_t{1} << bits) - 1;
+    }
+}
+
+TranspositionTable::TranspositionTable(std::size_t megabytes) {
+    std::size_t slots = 1;
+
+    while (slots * 2 * sizeof(Slot) <= megabytes * 1024 * 1024) {
+        slots *= 2;
+    }
+
+    slots_ = std::make_unique<Slot[]>(slots);
+    mask_ = slots - 1;
+
+    clear();
+}
+
+bool TranspositionTable::probe(std::uint64_t key, Entry& entry) const {
+    const Slot& slot = slots_[key & mask_];
+    const std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+
+    if ((slot.check.load(std::memory_order_relaxed) ^ data) != key || data == 0) {
+        return false;
+    }
+
+    entry = unpack(data);
+    return true;
+}
+
+void TranspositionTable::store(std::uint64_t key, const Entry& entry) {
+    Slot& slot = slots_[key & mask_];
+    const std::uint64_t old_data = slot.data.load(std::memory_order_relaxed);
+
+    // Keep a deeper result for the same position
+    if ((slot.check.load(std::memory_order_relaxed) ^ old_data) == key && old_data != 0
+        && unpack(old_data).depth > entry.depth) {
+        return;
+    }
+
+    const std::uint64_t data = pack(entry);
+    slot.check.store(key ^ data, std::memory_order_relaxed);
+    slot.data.store(data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::clear() {
+    for (std::size_t i = 0; i <= mask_; ++i) {
+        slots_[i].check.store(0, std::memory_order_relaxed);
+        slots_[i].data.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::uint64_t TranspositionTable::pack(const Entry& entry) {
+    assert(entry.score >= -max_score && entry.score <= max_score);
+    assert(entry.depth >= 0 && entry.depth <= static_cast<int>(field(depth_bits)));
+
+    // Offset the score so the packed score is never negative. A valid entry is
+    // then never all zeros, which marks an empty slot.
+    std::uint64_t data = static_cast<std::uint64_t>(entry.score + max_score + 1);
+    data |= static_cast<std::uint64_t>(entry.depth) << depth_shift;
+    data |= static_cast<std::uint64_t>(entry.type) << bound_shift;
+
+    if (entry.has_move) {
+        data |= std::uint64_t{1} << has_move_shift;
+        data |= static_cast<std::uint64_t>(entry.move.shape) << shape_shift;
+        data |= static_cast<std::uint64_t>(entry.move.x) << x_shift;
+        data |= static_cast<std::uint64_t>(entry.move.y) << y_shift;
+    }
+
+    return data;
+}
+
+TranspositionTable::Entry TranspositionTable::unpack(std::uint64_t data) {
+    Entry entry;
+    entry.score = static_cast<int>(data & field(score_bits)) - max_score - 1;
+    entry.depth = static_cast<int>((data >> depth_shift) & field(depth_bits));
+    entry.type = static_cast<bound>((data >> bound_shift) & field(bound_bits));
+    entry.has_move = (data >> has_move_shift) & 1;
+    entry.move.shape = static_cast<shape_id>((data >> shape_shift) & field(shape_bits));
+    entry.move.x = static_cast<int>((data >> x_shift) & field(position_bits));
+    entry.move.y = static_cast<int>((data >> y_shift) & field(position_bits));
+    return entry;
+}
@@ -0,0 +1,170 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "game.hpp"
+#include "components/board.hpp"
+#include "record/opening_book.hpp"
+#include "search/alpha_beta.hpp"
+
+// Builds an opening book by searching every position that can be reached in the
+// first few placements of a game. Each position is searched once, since a
+// position that's already in the book, or whose reflection is, is skipped along
+// with everything after it that was already reached through it.
+
+struct Options {
+    int blocks = Board::default_board_size;
+    int players = 2;
+    int plies = 2;
+    std::uint64_t nodes = 200000;
+    int depth = 64;
+    int threads = 1;
+    std::string out;
+};
+
+static void print_usage() {
+    std::cerr << "Usage: blockade_book --out FILE [options]\n"
+              << "  --out FILE    Opening book to create\n"
+              << "  --size N      Number of blocks on each side of the board (default 8)\n"
+              << "  --players N   Number of players, which is only 2 for now (default 2)\n"
+              << "  --plies N     Number of placements from the start of the game to\n"
+              << "                search every position of (default 2)\n"
+              << "  --nodes N     Nodes to search for each position (default 200000)\n"
+              << "  --depth N     Deepest number of plies to search (default 64)\n"
+              << "  --threads N   Threads used by each search (default 1)\n";
+}
+
+// Reads the options from the arguments. Returns false if they're invalid.
+static bool parse_options(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* option = argv[i];
+
+        if (i + 1 >= argc) {
+            return false;
+        } else if (std::strcmp(option, "--out") == 0) {
+            options.out = argv[++i];
+        } else if (std::strcmp(option, "--size") == 0) {
+            options.blocks = std::atoi(argv[++i]);
+        } else if (std::strcmp(option, "--players") == 0) {
+            options.players = std::atoi(argv[++i]);
+        } else if (std::strcmp(option, "--plies") == 0) {
+            options.plies = std::atoi(argv[++i]);
+        } else if (std::strcmp(option, "--nodes") == 0) {
+            options.nodes = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(option, "--depth") == 0) {
+            options.depth = std::atoi(argv[++i]);
+        } else if (std::strcmp(option, "--threads") == 0) {
+            options.threads = std::atoi(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+
+    return !options.out.empty() && options.blocks >= 2
+        && options.blocks <= Board::max_board_size
+        && options.players == Board::initial_square_players && options.plies >= 0
+        && options.nodes > 0 && options.depth > 0 && options.threads > 0;
+}
+
+// Walks the positions of the first placements of a game, searching each one
+// that isn't in the book yet.
+class BookBuilder {
+
+    public:
+        BookBuilder(const Options& options)
+            : game_(options.blocks, options.players, nullptr),
+              writer_(options.blocks, options.players),
+              search_(make_limits(options)),
+              placements_(options.plies) {}
+
+        // Adds the positions within `plies` placements of the current one.
+        void build(int plies) {
+            const Board& board = game_.get_board();
+            const int actor = game_.get_current_actor();
+            const int half_squares_placed = game_.get_half_squares_placed();
+
+            if (writer_.contains(board, actor, half_squares_placed)) {
+                return;
+            }
+
+            const AlphaBetaSearch::Turn turn = search_.search(board, game_.get_num_actors(), actor,
+                half_squares_placed);
+
+            // An actor with nothing to place has no move to store
+            if (turn.count == 0) {
+                return;
+            }
+
+            writer_.add_move(board, actor, half_squares_placed, turn.placements[0], turn.depth);
+
+            if (plies == 0) {
+                return;
+            }
+
+            // Each depth has its own placements so the ones being walked aren't
+            // written over by the positions after them
+            std::vector<Game::Placement>& placements = placements_[plies - 1];
+            const int count = Game::generate_placements(actor, half_squares_placed, board,
+                placements);
+
+            for (int i = 0; i < count; ++i) {
+                const Game::Placement placement = placements[i];
+
+                if (game_.make_move(placement)) {
+                    build(plies - 1);
+                    game_.unmake_move();
+                }
+            }
+        }
+
+        const OpeningBookWriter& get_writer() const {
+            return writer_;
+        }
+
+    private:
+        static AlphaBetaSearch::Limits make_limits(const Options& options) {
+            AlphaBetaSearch::Limits limits;
+            limits.threads = options.threads;
+            limits.time = std::chrono::milliseconds(0);
+            limits.nodes = options.nodes;
+            limits.max_depth = options.depth;
+            return limits;
+        }
+
+        Game game_;
+        OpeningBookWriter writer_;
+        AlphaBetaSearch search_;
+        std::vector<std::vector<Game::Placement>> placements_;
+};
+
+int main(int argc, char** argv) {
+    Options options;
+
+    if (!parse_options(argc, argv, options)) {
+        print_usage();
+        return EXIT_FAILURE;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    BookBuilder builder(options);
+    builder.build(options.plies);
+
+    const OpeningBookWriter& writer = builder.get_writer();
+
+    if (!writer.write(options.out)) {
+        std::cerr << "Could not write " << options.out << "\n";
+        return EXIT_FAILURE;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout.precision(3);
+    std::cout << writer.get_move_count() << " positions in " << elapsed.count() << " s\n";
+
+    return EXIT_SUCCESS;
+}
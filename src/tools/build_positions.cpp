@@ -0,0 +1,138 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "game.hpp"
+#include "actors/random_player.hpp"
+#include "components/board.hpp"
+#include "components/shapes.hpp"
+#include "record/position_store.hpp"
+
+// Builds a position store from random self-play. Every position of every game
+// is added, from the first placement to the end of the game, labelled with the
+// final scores of its game.
+
+struct Options {
+    int blocks = Board::default_board_size;
+    int players = 2;
+    int games = 1000;
+    std::uint64_t seed = 0;
+    int threads = 1;
+    std::string out;
+};
+
+static void print_usage() {
+    std::cerr << "Usage: blockade_positions --out FILE [options]\n"
+              << "  --out FILE    Position store to create\n"
+              << "  --size N      Number of blocks on each side of the board (default 8)\n"
+              << "  --players N   Number of players, which is only 2 for now (default 2)\n"
+              << "  --games N     Number of random games to play (default 1000)\n"
+              << "  --seed N      Seed of the first random game, the next games use the\n"
+              << "                following seeds (default 0)\n"
+              << "  --threads N   Threads used to check if a game is finished (default 1)\n";
+}
+
+// Reads the options from the arguments. Returns false if they're invalid.
+static bool parse_options(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* option = argv[i];
+
+        if (i + 1 >= argc) {
+            return false;
+        } else if (std::strcmp(option, "--out") == 0) {
+            options.out = argv[++i];
+        } else if (std::strcmp(option, "--size") == 0) {
+            options.blocks = std::atoi(argv[++i]);
+        } else if (std::strcmp(option, "--players") == 0) {
+            options.players = std::atoi(argv[++i]);
+        } else if (std::strcmp(option, "--games") == 0) {
+            options.games = std::atoi(argv[++i]);
+        } else if (std::strcmp(option, "--seed") == 0) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(option, "--threads") == 0) {
+            options.threads = std::atoi(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+
+    return !options.out.empty() && options.blocks >= 2
+        && options.blocks <= Board::max_board_size
+        && options.players == Board::initial_square_players && options.games >= 0;
+}
+
+int main(int argc, char** argv) {
+    Options options;
+
+    if (!parse_options(argc, argv, options)) {
+        print_usage();
+        return EXIT_FAILURE;
+    }
+
+    PositionStoreWriter writer(options.blocks, options.players);
+
+    if (!writer.open(options.out)) {
+        std::cerr << "Could not create " << options.out << "\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Game::Placement> placements;
+    Board board(options.blocks, options.players);
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < options.games; ++i) {
+        Game game(options.blocks, options.players, nullptr);
+        game.set_simulation_threads(options.threads);
+
+        RandomPlayer player(options.seed + i);
+        Game::Placement placement;
+        placements.clear();
+
+        while (!game.is_finished() && player.choose_placement(game, placement)) {
+            game.place(placement);
+            placements.push_back(placement);
+        }
+
+        const std::vector<float>& final_scores = game.get_final_scores();
+
+        // Play the game again to add its positions now that the scores are known
+        board.clear();
+        int actor = 0;
+        int half_squares_placed = 0;
+
+        for (const Game::Placement& next : placements) {
+            writer.add_position(board, board.get_key() ^ Game::get_turn_key(actor,
+                half_squares_placed), actor, half_squares_placed, final_scores);
+
+            board.place_piece(actor, next.shape, next.x, next.y);
+            half_squares_placed += next.shape == square_shape ? 2 : 1;
+
+            if (half_squares_placed == 2) {
+                half_squares_placed = 0;
+                actor = (actor + 1) % options.players;
+            }
+        }
+
+        writer.add_position(board, board.get_key() ^ Game::get_turn_key(actor,
+            half_squares_placed), actor, half_squares_placed, final_scores);
+    }
+
+    const std::uint64_t positions = writer.get_position_count();
+
+    if (!writer.finish()) {
+        std::cerr << "Could not write " << options.out << "\n";
+        return EXIT_FAILURE;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout.precision(3);
+    std::cout << positions << " positions from " << options.games << " games in "
+              << elapsed.count() << " s\n";
+
+    return EXIT_SUCCESS;
+}
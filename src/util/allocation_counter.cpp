@@ -0,0 +1,29 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "util/allocation_counter.hpp"
+
+static std::atomic<long long> allocations{0};
+
+long long get_allocation_count() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
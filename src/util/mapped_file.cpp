@@ -0,0 +1,80 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "util/mapped_file.hpp"
+
+MappedFile::MappedFile() : data_(nullptr), size_(0) {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path, std::size_t min_size) {
+    close();
+
+    const int file = ::open(path.c_str(), O_RDONLY);
+
+    if (file < 0) {
+        return false;
+    }
+
+    struct stat file_stat;
+
+    // Empty files can't be mapped, so they're never big enough
+    if (fstat(file, &file_stat) != 0 || file_stat.st_size == 0
+        || static_cast<std::size_t>(file_stat.st_size) < min_size) {
+        ::close(file);
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_SHARED, file, 0);
+
+    // The mapping stays valid after the file is closed
+    ::close(file);
+
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    data_ = static_cast<const unsigned char*>(mapping);
+    size_ = file_stat.st_size;
+
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_) {
+        munmap(const_cast<unsigned char*>(data_), size_);
+    }
+
+    data_ = nullptr;
+    size_ = 0;
+}
+
+const unsigned char* MappedFile::data() const {
+    return data_;
+}
+
+std::size_t MappedFile::size() const {
+    return size_;
+}
+
+std::uint64_t find_first_key(const unsigned char* entries, std::uint64_t count,
+    std::size_t entry_size, std::uint64_t key) {
+    std::uint64_t low = 0;
+    std::uint64_t high = count;
+
+    while (low < high) {
+        const std::uint64_t middle = low + (high - low) / 2;
+
+        if (load_unaligned<std::uint64_t>(entries + middle * entry_size) < key) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
@@ -0,0 +1,86 @@
+#include "util/thread_pool.hpp"
+
+ThreadPool::ThreadPool(int threads) {
+    task_ = nullptr;
+    task_count_ = 0;
+    next_task_ = 0;
+    batch_ = 0;
+    busy_workers_ = 0;
+    is_stopping_ = false;
+
+    for (int i = 0; i < threads; ++i) {
+        threads_.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        is_stopping_ = true;
+    }
+
+    batch_started_.notify_all();
+
+    for (std::thread& thread : threads_) {
+        thread.join();
+    }
+}
+
+int ThreadPool::get_thread_count() const {
+    return threads_.size();
+}
+
+void ThreadPool::run(int count, const std::function<void(int)>& task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        task_count_ = count;
+        next_task_ = 0;
+        busy_workers_ = threads_.size();
+        ++batch_;
+    }
+
+    batch_started_.notify_all();
+
+    run_tasks();
+
+    // Every worker has to be done with the batch before the task goes out of scope
+    std::unique_lock<std::mutex> lock(mutex_);
+    batch_finished_.wait(lock, [this] { return busy_workers_ == 0; });
+    task_ = nullptr;
+}
+
+void ThreadPool::work() {
+    std::uint64_t last_batch = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            batch_started_.wait(lock, [this, last_batch] {
+                return is_stopping_ || batch_ != last_batch;
+            });
+
+            if (is_stopping_) {
+                return;
+            }
+
+            last_batch = batch_;
+        }
+
+        run_tasks();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --busy_workers_;
+        }
+
+        batch_finished_.notify_one();
+    }
+}
+
+void ThreadPool::run_tasks() {
+    // Tasks are handed out one at a time so the threads stay balanced
+    for (int i = next_task_++; i < task_count_; i = next_task_++) {
+        (*task_)(i);
+    }
+}
@@ -6,6 +6,8 @@
 #include "components/board.hpp"
 #include "components/piece.hpp"
 #include "components/rectangle.hpp"
+#include "components/square.hpp"
+#include "components/triangle.hpp"
 
 // Tests the placement of valid and invalid placements. Also checks if
 // placing pieces on the board does not modify the points.
@@ -60,3 +62,140 @@ TEST_CASE("clear", "[clear]") {
 }
 
 
+// Tests that slots report their pieces in the order they were placed and
+// that only a matching half can fill the rest of a slot.
+TEST_CASE("slots", "[slot, place]") {
+
+    Board board;
+
+    std::shared_ptr<Piece> t = std::make_shared<Triangle>(0);
+    std::shared_ptr<Piece> t2 = std::make_shared<Triangle>(1);
+    std::shared_ptr<Piece> s = std::make_shared<Square>(1);
+
+    int x = 3;
+    int y = 4;
+
+    // Place the half with the larger shape index first.
+    t->rotate();
+    t->rotate();
+    REQUIRE(board.place_piece(t, x, y));
+
+    // A square and a triangle that isn't rotated 180 degrees don't fit.
+    t2->rotate();
+    REQUIRE_FALSE(board.place_piece(s, x, y));
+    REQUIRE_FALSE(board.place_piece(t2, x, y));
+
+    t2->rotate(Piece::rotation::counterclockwise);
+    REQUIRE(board.place_piece(t2, x, y));
+
+    Board::slot_contents slot = board.get_slot(x, y);
+    CHECK(slot.first.owner == 0);
+    CHECK(slot.first.shape == t->get_shape());
+    CHECK(slot.second.owner == 1);
+    CHECK(slot.second.shape == t2->get_shape());
+
+    // Nothing fits in the initial squares.
+    REQUIRE_FALSE(board.place_piece(t2, 0, board.get_size() - 1));
+}
+
+// Tests the score of each player and that copies of a board are independent.
+TEST_CASE("score", "[score]") {
+
+    Board board;
+
+    CHECK(board.get_score(0) == 1.0f);
+    CHECK(board.get_score(1) == 1.0f);
+
+    Board copy = board;
+
+    std::shared_ptr<Piece> r = std::make_shared<Rectangle>(0);
+    REQUIRE(copy.place_piece(r, 1, 6));
+
+    CHECK(copy.get_score(0) == 1.5f);
+    CHECK(board.get_score(0) == 1.0f);
+    CHECK(!board.get_slot(1, 6).first);
+}
+
+// Tests that pieces are connected through any shared point, including the
+// middle of the side of a slot.
+TEST_CASE("touching", "[touching]") {
+
+    Board board;
+
+    // The initial square of the first player touches its neighbours by corners.
+    CHECK(board.check_if_touching_owner(0, square_shape, 1, board.get_size() - 2));
+    CHECK_FALSE(board.check_if_touching_owner(1, square_shape, 1, board.get_size() - 2));
+    CHECK_FALSE(board.check_if_touching_owner(0, square_shape, 2, board.get_size() - 1));
+
+    // A rectangle in the top half of a slot has points in the middle of its
+    // left and right sides.
+    REQUIRE(board.place_piece(1, rectangle_shape, 3, 3));
+    CHECK(board.check_if_touching_owner(1, rectangle_shape, 4, 3));
+    CHECK_FALSE(board.check_if_touching_owner(1, square_shape, 5, 3));
+
+    // Rotated 90 degrees it's in the right half and only has points in the
+    // middle of the top and bottom sides.
+    CHECK_FALSE(board.check_if_touching_owner(1, get_shape_info(rectangle_shape).clockwise, 4, 3));
+    CHECK(board.check_if_touching_owner(1, square_shape, 4, 2));
+    CHECK_FALSE(board.check_if_touching_owner(1, square_shape, 4, 4));
+}
+
+// Tests that removing pieces leaves the board as if they were never placed.
+TEST_CASE("remove", "[remove, place]") {
+
+    Board board;
+    const Board empty;
+
+    // Only pieces that are on the board can be removed.
+    CHECK_FALSE(board.remove_piece(1, square_shape, 3, 3));
+    REQUIRE(board.place_piece(1, rectangle_shape, 3, 3));
+    CHECK_FALSE(board.remove_piece(0, rectangle_shape, 3, 3));
+    CHECK_FALSE(board.remove_piece(1, rectangle_shape + 2, 3, 3));
+
+    // A square next to the rectangle shares a corner with it, which stays a
+    // point of the owner once the rectangle is removed, unlike the middle of
+    // the side they share.
+    REQUIRE(board.place_piece(1, square_shape, 4, 3));
+    CHECK(board.get_touching_points(1, 3, 3) == 0x12D);
+    REQUIRE(board.remove_piece(1, rectangle_shape, 3, 3));
+    CHECK(board.get_touching_points(1, 3, 3) == 0x104);
+    CHECK_FALSE(board.check_if_touching_owner(1, square_shape, 2, 3));
+
+    REQUIRE(board.remove_piece(1, square_shape, 4, 3));
+    CHECK(board.get_touching_points(1, 3, 3) == 0);
+    CHECK(board.get_key() == empty.get_key());
+    CHECK(board.get_score(1) == empty.get_score(1));
+
+    // Removing the half placed first leaves the other half as the only half.
+    REQUIRE(board.place_piece(0, triangle_shape + 2, 2, 2));
+    REQUIRE(board.place_piece(1, triangle_shape, 2, 2));
+    REQUIRE(board.remove_piece(0, triangle_shape + 2, 2, 2));
+    CHECK(board.get_slot(2, 2).first == Board::slot_piece{1, triangle_shape});
+    CHECK_FALSE(board.get_slot(2, 2).second);
+
+    REQUIRE(board.place_piece(0, triangle_shape + 2, 2, 2));
+    CHECK(board.get_slot(2, 2).first == Board::slot_piece{1, triangle_shape});
+    CHECK(board.get_slot(2, 2).second == Board::slot_piece{0, triangle_shape + 2});
+    CHECK(board.get_key() == board.compute_key());
+}
+
+// Tests boards with sizes other than the default size.
+TEST_CASE("size", "[size, place]") {
+
+    Board small(2);
+    Board large(Board::max_board_size);
+
+    REQUIRE(small.get_size() == 2);
+    REQUIRE(large.get_size() == Board::max_board_size);
+
+    // The initial squares are in the corners no matter the size.
+    const int last = large.get_size() - 1;
+    CHECK(large.get_slot(0, last).first == Board::slot_piece{0, square_shape});
+    CHECK(large.get_slot(last, 0).first == Board::slot_piece{1, square_shape});
+    CHECK(small.get_slot(1, 0).first == Board::slot_piece{1, square_shape});
+
+    REQUIRE(large.place_piece(1, square_shape, last - 1, 1));
+    CHECK(large.check_if_touching_owner(1, square_shape, last - 2, 2));
+    CHECK(large.get_score(1) == 2.0f);
+    CHECK(large.get_score(0) == 1.0f);
+}
@@ -5,9 +5,11 @@
 
 #include "components/board.hpp"
 #include "components/piece.hpp"
+#include "components/piece_registry.hpp"
 #include "components/triangle.hpp"
 #include "components/square.hpp"
 #include "components/rectangle.hpp"
+#include "components/shapes.hpp"
 
 
 TEST_CASE("Triangle Construction", "[triangle, construction]") {
@@ -226,3 +228,46 @@ TEST_CASE("Piece Rotation", "[triangle, rectangle, square, rotation]") {
     t2.rotate(Piece::rotation::counterclockwise);
     CHECK(t1 == t2);
 }
+
+// The catalogue should agree with the pieces and only let halves that are
+// rotated 180 degrees from each other share a slot.
+TEST_CASE("Shape Catalogue", "[triangle, rectangle, square, shapes]") {
+    Triangle t = Triangle(0);
+    Rectangle r = Rectangle(0);
+
+    for (int rotations = 0; rotations < 4; ++rotations) {
+        CHECK(get_shape_info(t.get_shape()).rotation == rotations * 90);
+        CHECK(Triangle(0, t.get_shape()).get_points() == t.get_points());
+        CHECK(Rectangle(0, r.get_shape()).get_points() == r.get_points());
+        t.rotate();
+        r.rotate();
+    }
+
+    for (shape_id shape = 0; shape < shape_count; ++shape) {
+        const ShapeInfo& info = get_shape_info(shape);
+
+        CHECK(get_shape_info(info.clockwise).counterclockwise == shape);
+        CHECK(get_shape_info(info.partner).partner == shape);
+
+        for (shape_id other = 0; other < shape_count; ++other) {
+            const bool fits = (info.regions & get_shape_info(other).regions) == 0;
+            CHECK(fits == (shape != square_shape && info.partner == other));
+        }
+    }
+}
+
+// The registry should hand out the same piece every time it's asked for one.
+TEST_CASE("Interned Pieces", "[triangle, rectangle, square, registry]") {
+    for (int owner : {0, 1, 3}) {
+        for (shape_id shape = 0; shape < shape_count; ++shape) {
+            std::shared_ptr<const Piece> piece = PieceRegistry::get_piece(owner, shape);
+
+            CHECK(piece->get_owner_id() == owner);
+            CHECK(piece->get_shape() == shape);
+            CHECK(piece->get_piece_type() == get_shape_info(shape).type);
+            CHECK(piece == PieceRegistry::get_piece(owner, shape));
+        }
+    }
+
+    CHECK(PieceRegistry::get_piece(0, square_shape) != PieceRegistry::get_piece(1, square_shape));
+}
@@ -0,0 +1,142 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "input/input_handler.hpp"
+#include "input/keys.hpp"
+#include "util/spsc_queue.hpp"
+
+using namespace std::chrono_literals;
+
+using event_type = InputHandler::Event::event_type;
+
+// Tests that holding a key down only gives one press.
+TEST_CASE("Key Presses", "[input, press]") {
+    InputHandler input_handler;
+    InputHandler::Event event;
+    const InputHandler::clock::time_point start = InputHandler::clock::now();
+
+    CHECK_FALSE(input_handler.poll_event(event));
+
+    // Keys repeat while they're held down
+    input_handler.push_key_event(mouse_button_left, true, start);
+    input_handler.push_key_event(mouse_button_left, true, start + 100ms);
+
+    REQUIRE(input_handler.poll_event(event));
+    CHECK(event.type == event_type::press);
+    CHECK(event.key == mouse_button_left);
+    CHECK(event.time == start);
+    CHECK(input_handler.get_key_state(mouse_button_left));
+    CHECK_FALSE(input_handler.poll_event(event));
+
+    // Releasing and pressing again is a new press
+    input_handler.push_key_event(mouse_button_left, false, start + 200ms);
+    CHECK_FALSE(input_handler.poll_event(event));
+    CHECK_FALSE(input_handler.get_key_state(mouse_button_left));
+
+    input_handler.push_key_event(mouse_button_left, true, start + 300ms);
+    CHECK(input_handler.poll_event(event));
+
+    // Unknown keys are ignored
+    input_handler.push_key_event(-1, true, start + 400ms);
+    input_handler.push_key_event(key_code_count, true, start + 400ms);
+    CHECK_FALSE(input_handler.poll_event(event));
+}
+
+// Tests that quick clicks and scrolls between polls each come out once and in order.
+TEST_CASE("Key Event Order", "[input, events]") {
+    InputHandler input_handler;
+    InputHandler::Event event;
+    const InputHandler::clock::time_point start = InputHandler::clock::now();
+
+    input_handler.push_key_event(mouse_button_left, true, start);
+    input_handler.push_key_event(mouse_button_left, false, start + 40ms);
+    input_handler.push_scroll_event(-1, start + 50ms);
+    input_handler.push_scroll_event(1, start + 60ms);
+    input_handler.push_key_event(mouse_button_left, true, start + 80ms);
+
+    REQUIRE(input_handler.poll_event(event));
+    CHECK(event.type == event_type::press);
+    REQUIRE(input_handler.poll_event(event));
+    CHECK(event.type == event_type::scroll);
+    CHECK(event.yoffset == -1);
+    REQUIRE(input_handler.poll_event(event));
+    CHECK(event.yoffset == 1);
+    REQUIRE(input_handler.poll_event(event));
+    CHECK(event.type == event_type::press);
+    CHECK(event.time == start + 80ms);
+    CHECK_FALSE(input_handler.poll_event(event));
+}
+
+// Tests that presses too close together are ignored.
+TEST_CASE("Key Debounce", "[input, debounce]") {
+    InputHandler input_handler;
+    InputHandler::Event event;
+    const InputHandler::clock::time_point start = InputHandler::clock::now();
+
+    input_handler.push_key_event(mouse_button_left, true, start);
+    input_handler.push_key_event(mouse_button_left, false, start + 5ms);
+    input_handler.push_key_event(mouse_button_left, true, start + 10ms);
+
+    CHECK(input_handler.poll_event(event));
+    CHECK_FALSE(input_handler.poll_event(event));
+    CHECK(input_handler.get_key_state(mouse_button_left));
+
+    input_handler.push_key_event(mouse_button_left, false, start + 20ms);
+    input_handler.push_key_event(mouse_button_left, true, start + InputHandler::debounce_time);
+    CHECK(input_handler.poll_event(event));
+}
+
+// Tests that the queue keeps values in order across threads and when full.
+TEST_CASE("Event Queue", "[input, queue]") {
+    SpscQueue<int, 4> small;
+    int value;
+
+    for (int i = 0; i < 4; ++i) {
+        REQUIRE(small.push(i));
+    }
+
+    CHECK_FALSE(small.push(4));
+    REQUIRE(small.pop(value));
+    CHECK(value == 0);
+    REQUIRE(small.push(4));
+
+    for (int i = 1; i <= 4; ++i) {
+        REQUIRE(small.pop(value));
+        CHECK(value == i);
+    }
+
+    CHECK_FALSE(small.pop(value));
+
+    // One thread pushes while another pops
+    SpscQueue<std::uint64_t, 64> queue;
+    const std::uint64_t count = 100000;
+
+    std::thread producer([&queue, count] {
+        for (std::uint64_t i = 0; i < count; ++i) {
+            while (!queue.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::uint64_t expected = 0;
+    bool is_in_order = true;
+
+    while (expected < count) {
+        std::uint64_t popped;
+
+        if (queue.pop(popped)) {
+            is_in_order = is_in_order && popped == expected;
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+    CHECK(is_in_order);
+}
@@ -0,0 +1,174 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "game.hpp"
+#include "actors/random_player.hpp"
+#include "components/board.hpp"
+#include "components/shapes.hpp"
+#include "record/game_record.hpp"
+
+// Records random games through a game, keeping the keys of the boards they
+// ended on and their placements.
+static std::string record_random_games(int games, int blocks, std::vector<std::uint64_t>& keys,
+    std::vector<int>& placement_counts) {
+    std::ostringstream out;
+    GameRecordWriter writer(out);
+
+    for (int seed = 0; seed < games; ++seed) {
+        Game game(blocks, 2, nullptr);
+        RandomPlayer player(seed);
+        Game::Placement placement;
+        int placements = 0;
+
+        writer.begin_game(GameRecordHeader{blocks, 2, static_cast<std::uint64_t>(seed)});
+        game.set_record_writer(&writer);
+
+        while (!game.is_finished() && player.choose_placement(game, placement)) {
+            REQUIRE(game.place(placement));
+            ++placements;
+        }
+
+        // Invalid placements aren't recorded
+        CHECK_FALSE(game.place(Game::Placement{0, 0, square_shape}));
+
+        writer.end_game();
+        keys.push_back(game.get_board().get_key());
+        placement_counts.push_back(placements);
+    }
+
+    return out.str();
+}
+
+// Tests that replaying recorded games ends on the same boards.
+TEST_CASE("Replay Games", "[record, replay]") {
+    std::vector<std::uint64_t> keys;
+    std::vector<int> placement_counts;
+    const std::string record = record_random_games(10, 8, keys, placement_counts);
+
+    std::istringstream in(record);
+    GameReplayer replayer(in);
+    REQUIRE(replayer.is_valid());
+
+    int games = 0;
+    int total_placements = 0;
+
+    while (replayer.next_game()) {
+        REQUIRE(games < 10);
+        CHECK(replayer.get_header().blocks == 8);
+        CHECK(replayer.get_header().players == 2);
+        CHECK(replayer.get_header().seed == static_cast<std::uint64_t>(games));
+
+        const int placements = replayer.replay_game();
+        CHECK(placements == placement_counts[games]);
+        CHECK(replayer.get_board().get_key() == keys[games]);
+
+        total_placements += placements;
+        ++games;
+    }
+
+    CHECK(replayer.is_valid());
+    CHECK(games == 10);
+
+    // Each game has a header of three bytes and an end, and each placement
+    // takes one or two bytes on a small board.
+    const std::size_t overhead = record_magic.size() + 1 + games * 4;
+    const std::size_t placement_bytes = static_cast<std::size_t>(total_placements);
+    CHECK(record.size() >= overhead + placement_bytes);
+    CHECK(record.size() <= overhead + 2 * placement_bytes);
+}
+
+// Tests that games can be skipped and that large numbers are read back.
+TEST_CASE("Record Reader", "[record, reader]") {
+    std::ostringstream out;
+    GameRecordWriter writer(out);
+
+    writer.begin_game(GameRecordHeader{1024, 2, ~std::uint64_t{0}});
+    writer.add_placement(Game::Placement{1023, 1023, 8});
+    writer.add_placement(Game::Placement{0, 0, 0});
+    writer.end_game();
+
+    writer.begin_game(GameRecordHeader{5, 2, 7});
+    writer.add_placement(Game::Placement{4, 2, triangle_shape});
+    writer.end_game();
+
+    std::istringstream in(out.str());
+    GameRecordReader reader(in);
+    GameRecordHeader header;
+    Game::Placement placement;
+
+    REQUIRE(reader.next_game(header));
+    CHECK(header.blocks == 1024);
+    CHECK(header.players == 2);
+    CHECK(header.seed == ~std::uint64_t{0});
+
+    REQUIRE(reader.next_placement(placement));
+    CHECK(placement.x == 1023);
+    CHECK(placement.y == 1023);
+    CHECK(placement.shape == 8);
+
+    // Skip the rest of the first game
+    REQUIRE(reader.next_game(header));
+    CHECK(header.blocks == 5);
+    CHECK(header.seed == 7);
+
+    REQUIRE(reader.next_placement(placement));
+    CHECK(placement.x == 4);
+    CHECK(placement.y == 2);
+    CHECK(placement.shape == triangle_shape);
+    CHECK_FALSE(reader.next_placement(placement));
+
+    CHECK_FALSE(reader.next_game(header));
+    CHECK(reader.is_valid());
+}
+
+// Tests that records that are cut short or aren't records are invalid.
+TEST_CASE("Invalid Records", "[record, reader]") {
+    std::istringstream not_a_record("not a record");
+    CHECK_FALSE(GameRecordReader(not_a_record).is_valid());
+
+    std::vector<std::uint64_t> keys;
+    std::vector<int> placement_counts;
+    const std::string record = record_random_games(1, 6, keys, placement_counts);
+
+    // Without the zero at the end the game is cut short
+    std::istringstream in(record.substr(0, record.size() - 1));
+    GameReplayer replayer(in);
+
+    REQUIRE(replayer.next_game());
+    CHECK(replayer.replay_game() == placement_counts[0]);
+    CHECK_FALSE(replayer.is_valid());
+    CHECK_FALSE(replayer.next_game());
+
+    // Only as many players as have initial squares can be in a game, so a
+    // header can't ask for boards with planes for thousands of players. An
+    // empty game is its header of three bytes and an end, so the players are
+    // replaced in it, with numbers written seven bits at a time.
+    std::ostringstream out;
+    GameRecordWriter writer(out);
+    writer.begin_game(GameRecordHeader{6, 2, 0});
+    writer.end_game();
+
+    const std::string empty_game = out.str();
+    const std::string start = empty_game.substr(0, empty_game.size() - 4);
+
+    for (const std::string players : {"\x00", "\x01", "\x03", "\xFF\xFF\x03"}) {
+        std::istringstream many_in(start + '\x06' + players + std::string(2, '\0'));
+        GameRecordReader reader(many_in);
+        GameRecordHeader header;
+
+        REQUIRE(reader.is_valid());
+        CHECK_FALSE(reader.next_game(header));
+        CHECK_FALSE(reader.is_valid());
+    }
+
+    // The same game with two players is read
+    std::istringstream two_in(empty_game);
+    GameRecordReader reader(two_in);
+    GameRecordHeader header;
+    CHECK(reader.next_game(header));
+    CHECK(header.players == 2);
+}
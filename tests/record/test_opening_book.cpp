@@ -0,0 +1,251 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "game.hpp"
+#include "actors/random_player.hpp"
+#include "actors/search_player.hpp"
+#include "components/board.hpp"
+#include "record/opening_book.hpp"
+
+// A position that was added to a book, to check the book against.
+struct BookPosition {
+    Board board;
+    int actor;
+    int half_squares_placed;
+    Game::Placement placement;
+};
+
+// Plays some random games and gets every position of them along with the
+// placement that was made in it.
+static std::vector<BookPosition> play_positions(int games) {
+    std::vector<BookPosition> positions;
+
+    for (int seed = 0; seed < games; ++seed) {
+        Game game(6, 2, nullptr);
+        RandomPlayer player(seed);
+        Game::Placement placement;
+
+        while (!game.is_finished() && player.choose_placement(game, placement)) {
+            positions.push_back(BookPosition{game.get_board(), game.get_current_actor(),
+                game.get_half_squares_placed(), placement});
+            REQUIRE(game.place(placement));
+        }
+    }
+
+    return positions;
+}
+
+static bool operator==(const Game::Placement& lhs, const Game::Placement& rhs) {
+    return lhs.x == rhs.x && lhs.y == rhs.y && lhs.shape == rhs.shape;
+}
+
+// Tests that reflected positions have the same placements, reflected.
+TEST_CASE("Reflected Positions", "[book]") {
+    const std::vector<BookPosition> positions = play_positions(4);
+    Board reflected(6);
+    std::vector<Game::Placement> placements;
+    std::vector<Game::Placement> reflected_placements;
+
+    for (const BookPosition& position : positions) {
+        reflect_board(position.board, reflected);
+
+        bool is_reflected;
+        bool reflected_is_reflected;
+        const std::uint64_t key = get_book_key(position.board, position.actor,
+            position.half_squares_placed, is_reflected);
+        CHECK(get_book_key(reflected, position.actor, position.half_squares_placed,
+            reflected_is_reflected) == key);
+
+        // Only a board that's the same as its reflection is stored as itself both ways
+        if (reflected.get_key() != position.board.get_key()) {
+            CHECK(is_reflected != reflected_is_reflected);
+        }
+
+        const int count = Game::generate_placements(position.actor,
+            position.half_squares_placed, position.board, placements);
+        CHECK(Game::generate_placements(position.actor, position.half_squares_placed,
+            reflected, reflected_placements) == count);
+
+        for (int i = 0; i < count; ++i) {
+            const Game::Placement placement = reflect_placement(placements[i], 6);
+            CHECK(reflect_placement(placement, 6) == placements[i]);
+
+            Game game(6, 2, nullptr);
+            CHECK(game.check_if_valid_placement(position.actor, placement.shape, placement.x,
+                placement.y, position.half_squares_placed, reflected));
+        }
+
+        // Reflecting the board back gives the same board
+        Board original(6);
+        reflect_board(reflected, original);
+        CHECK(original.get_key() == position.board.get_key());
+    }
+}
+
+// Tests that the placements added to a book are found in it, for both a
+// position and its reflection.
+TEST_CASE("Opening Book Moves", "[book]") {
+    const std::string path = "test_opening_book.bin";
+    const std::vector<BookPosition> positions = play_positions(3);
+
+    OpeningBookWriter writer(6, 2);
+
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        const BookPosition& position = positions[i];
+        writer.add_move(position.board, position.actor, position.half_squares_placed,
+            position.placement, static_cast<int>(i % 256));
+        CHECK(writer.contains(position.board, position.actor, position.half_squares_placed));
+    }
+
+    // Every game starts the same way, so there are fewer moves than positions
+    CHECK(writer.get_move_count() < positions.size());
+    REQUIRE(writer.write(path));
+
+    OpeningBook book;
+    REQUIRE(book.open(path));
+    CHECK(book.size() == writer.get_move_count());
+    CHECK(book.get_board_size() == 6);
+    CHECK(book.get_players() == 2);
+
+    Board reflected(6);
+
+    for (const BookPosition& position : positions) {
+        Game::Placement placement;
+        int depth;
+        REQUIRE(book.find(position.board, position.actor, position.half_squares_placed,
+            placement, depth));
+        CHECK(depth < 256);
+
+        // The first placement added for the position or its reflection is kept
+        OpeningBookWriter first(6, 2);
+        for (const BookPosition& earlier : positions) {
+            if (first.contains(position.board, position.actor, position.half_squares_placed)) {
+                break;
+            }
+
+            first.add_move(earlier.board, earlier.actor, earlier.half_squares_placed,
+                earlier.placement, 0);
+
+            if (first.contains(position.board, position.actor, position.half_squares_placed)) {
+                const bool is_same = earlier.board.get_key() == position.board.get_key();
+                CHECK(placement == (is_same ? earlier.placement
+                    : reflect_placement(earlier.placement, 6)));
+            }
+        }
+
+        // The reflection of the position gets the reflected placement, unless
+        // it's the same board
+        reflect_board(position.board, reflected);
+        Game::Placement reflected_placement;
+        REQUIRE(book.find(reflected, position.actor, position.half_squares_placed,
+            reflected_placement));
+
+        if (reflected.get_key() == position.board.get_key()) {
+            CHECK(reflected_placement == placement);
+        } else {
+            CHECK(reflected_placement == reflect_placement(placement, 6));
+        }
+
+        Game game(6, 2, nullptr);
+        CHECK(game.check_if_valid_placement(position.actor, placement.shape, placement.x,
+            placement.y, position.half_squares_placed, position.board));
+    }
+
+    // A different turn isn't in the book
+    Game::Placement placement;
+    CHECK_FALSE(book.find(positions[0].board, 1, 0, placement));
+
+    // Boards of other sizes are never in the book
+    CHECK_FALSE(book.find(Board(8), 0, 0, placement));
+
+    book.close();
+    CHECK(book.size() == 0);
+    CHECK_FALSE(book.find(positions[0].board, 0, 0, placement));
+
+    std::remove(path.c_str());
+}
+
+// Tests that files that aren't complete opening books can't be opened.
+TEST_CASE("Invalid Opening Books", "[book]") {
+    const std::string path = "test_opening_book_invalid.bin";
+    OpeningBook book;
+
+    CHECK_FALSE(book.open("missing_opening_book.bin"));
+
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "not an opening book, but long enough to have a header in it.....";
+    }
+
+    CHECK_FALSE(book.open(path));
+
+    // Cut off part of the last entry
+    OpeningBookWriter writer(6, 2);
+    const Board board(6);
+    writer.add_move(board, 0, 0, Game::Placement{0, 5, square_shape}, 1);
+    REQUIRE(writer.write(path));
+    REQUIRE(book.open(path));
+    CHECK(book.size() == 1);
+
+    std::string contents;
+
+    {
+        std::ifstream in(path, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(contents.data(), contents.size() - 4);
+    }
+
+    CHECK_FALSE(book.open(path));
+    CHECK(book.size() == 0);
+    std::remove(path.c_str());
+}
+
+// Tests that a computer player plays the book's placement without searching.
+TEST_CASE("Opening Book Players", "[book]") {
+    const std::string path = "test_opening_book_player.bin";
+    const Game::Placement book_placement{1, 4, square_shape};
+
+    Game game(6, 2, nullptr);
+    REQUIRE(game.check_if_valid_placement(0, book_placement.shape, book_placement.x,
+        book_placement.y, 0, game.get_board()));
+
+    OpeningBookWriter writer(6, 2);
+    writer.add_move(game.get_board(), 0, 0, book_placement, 1);
+    REQUIRE(writer.write(path));
+
+    auto book = std::make_shared<OpeningBook>();
+    REQUIRE(book->open(path));
+
+    AlphaBetaSearch::Limits limits;
+    limits.time = std::chrono::milliseconds(0);
+    limits.nodes = 1000;
+    AlphaBetaPlayer player(limits);
+    player.set_opening_book(book);
+
+    REQUIRE(player.do_action(game) == Action::PLACE);
+
+    int x;
+    int y;
+    shape_id shape;
+    REQUIRE(player.get_cursor(x, y, shape));
+    CHECK(x == book_placement.x);
+    CHECK(y == book_placement.y);
+    CHECK(shape == book_placement.shape);
+
+    // The next position isn't in the book, so the player searches it
+    REQUIRE(game.place(book_placement));
+    CHECK(player.do_action(game) == Action::NONE);
+
+    book->close();
+    std::remove(path.c_str());
+}
@@ -0,0 +1,181 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "game.hpp"
+#include "actors/random_player.hpp"
+#include "components/board.hpp"
+#include "record/position_store.hpp"
+
+// A position that was added to a store, to check the store against.
+struct AddedPosition {
+    Board board;
+    std::uint64_t key;
+    int actor;
+    int half_squares_placed;
+    std::vector<float> final_scores;
+};
+
+// Adds every position of some random games to a store.
+static std::vector<AddedPosition> build_store(const std::string& path, int games) {
+    std::vector<AddedPosition> added;
+    PositionStoreWriter writer(6, 2);
+    REQUIRE(writer.open(path));
+
+    for (int seed = 0; seed < games; ++seed) {
+        Game game(6, 2, nullptr);
+        RandomPlayer player(seed);
+        Game::Placement placement;
+        const std::size_t first = added.size();
+
+        while (true) {
+            added.push_back(AddedPosition{game.get_board(), game.get_key(),
+                game.get_current_actor(), game.get_half_squares_placed(), {}});
+
+            if (game.is_finished() || !player.choose_placement(game, placement)) {
+                break;
+            }
+
+            REQUIRE(game.place(placement));
+        }
+
+        for (std::size_t i = first; i < added.size(); ++i) {
+            added[i].final_scores = game.get_final_scores();
+            writer.add_position(added[i].board, added[i].key, added[i].actor,
+                added[i].half_squares_placed, added[i].final_scores);
+        }
+    }
+
+    REQUIRE(writer.get_position_count() == added.size());
+    REQUIRE(writer.finish());
+
+    return added;
+}
+
+// Tests that positions read back the same as they were added.
+TEST_CASE("Position Records", "[positions, store]") {
+    const std::string path = "test_position_store.bin";
+    const std::vector<AddedPosition> added = build_store(path, 4);
+
+    PositionStore store;
+    REQUIRE(store.open(path));
+    REQUIRE(store.size() == added.size());
+    CHECK(store.get_board_size() == 6);
+    CHECK(store.get_players() == 2);
+
+    Board board(6);
+    std::size_t i = 0;
+
+    for (PositionView position : store) {
+        const AddedPosition& expected = added[i++];
+
+        CHECK(position.get_key() == expected.key);
+        CHECK(position.get_current_actor() == expected.actor);
+        CHECK(position.get_half_squares_placed() == expected.half_squares_placed);
+        CHECK(position.get_final_score(0) == expected.final_scores[0]);
+        CHECK(position.get_final_score(1) == expected.final_scores[1]);
+
+        for (int y = 0; y < 6; ++y) {
+            for (int x = 0; x < 6; ++x) {
+                const Board::slot_contents slot = position.get_slot(x, y);
+                const Board::slot_contents expected_slot = expected.board.get_slot(x, y);
+                CHECK(slot.first == expected_slot.first);
+                CHECK(slot.second == expected_slot.second);
+            }
+        }
+
+        // The board made from the record has the same pieces in the same order
+        position.copy_to_board(board);
+        CHECK(board.get_key() == expected.board.get_key());
+    }
+
+    CHECK(i == added.size());
+    CHECK(store.end() - store.begin() == static_cast<std::ptrdiff_t>(added.size()));
+
+    store.close();
+    std::remove(path.c_str());
+}
+
+// Tests that positions are found by their keys.
+TEST_CASE("Position Lookup", "[positions, store]") {
+    const std::string path = "test_position_lookup.bin";
+    const std::vector<AddedPosition> added = build_store(path, 3);
+
+    PositionStore store;
+    REQUIRE(store.open(path));
+
+    for (const AddedPosition& expected : added) {
+        const std::int64_t index = store.find(expected.key);
+        REQUIRE(index >= 0);
+        CHECK(store[index].get_key() == expected.key);
+
+        // The first position added with the key is found, such as the start of
+        // the board that every game has
+        CHECK(added[index].key == expected.key);
+        for (std::int64_t earlier = 0; earlier < index; ++earlier) {
+            CHECK(added[earlier].key != expected.key);
+        }
+    }
+
+    CHECK(store.find(added[0].key ^ 1) == -1);
+
+    store.close();
+    std::remove(path.c_str());
+}
+
+// Tests that scores of more squares than 16 bits can count read back the same.
+TEST_CASE("Large Position Scores", "[positions, store]") {
+    const std::string path = "test_position_scores.bin";
+    const Board board(256);
+    const std::vector<float> final_scores{40000.5f, 65535.0f};
+
+    PositionStoreWriter writer(256, 2);
+    REQUIRE(writer.open(path));
+    writer.add_position(board, board.get_key(), 0, 0, final_scores);
+    REQUIRE(writer.finish());
+
+    PositionStore store;
+    REQUIRE(store.open(path));
+    REQUIRE(store.size() == 1);
+    CHECK(store[0].get_final_score(0) == final_scores[0]);
+    CHECK(store[0].get_final_score(1) == final_scores[1]);
+
+    store.close();
+    std::remove(path.c_str());
+}
+
+// Tests that files that aren't complete position stores can't be opened.
+TEST_CASE("Invalid Position Stores", "[positions, store]") {
+    const std::string path = "test_position_invalid.bin";
+    PositionStore store;
+
+    CHECK_FALSE(store.open("missing_position_store.bin"));
+
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "not a position store, but long enough to have a header in it.....";
+    }
+
+    CHECK_FALSE(store.open(path));
+
+    // Cut off part of the index
+    build_store(path, 1);
+    std::string contents;
+
+    {
+        std::ifstream in(path, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(contents.data(), contents.size() - 8);
+    }
+
+    CHECK_FALSE(store.open(path));
+    std::remove(path.c_str());
+}
@@ -0,0 +1,346 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "game.hpp"
+#include "actors/search_player.hpp"
+#include "actors/random_player.hpp"
+#include "components/shapes.hpp"
+#include "search/alpha_beta.hpp"
+#include "search/fill_solver.hpp"
+#include "search/reachable_region.hpp"
+#include "search/monte_carlo.hpp"
+#include "search/transposition_table.hpp"
+
+// Tests that entries come back out of the table the same as they went in.
+TEST_CASE("Transposition Table", "[search, table]") {
+    TranspositionTable table(1);
+    TranspositionTable::Entry entry;
+
+    REQUIRE_FALSE(table.probe(12345, entry));
+
+    TranspositionTable::Entry stored{-4321, 7, TranspositionTable::bound::upper, true,
+        Game::Placement{1023, 17, rectangle_shape + 3}};
+    table.store(12345, stored);
+
+    REQUIRE(table.probe(12345, entry));
+    CHECK(entry.score == -4321);
+    CHECK(entry.depth == 7);
+    CHECK(entry.type == TranspositionTable::bound::upper);
+    CHECK(entry.has_move);
+    CHECK(entry.move.x == 1023);
+    CHECK(entry.move.y == 17);
+    CHECK(entry.move.shape == rectangle_shape + 3);
+
+    // A shallower result doesn't replace a deeper one for the same position
+    table.store(12345, TranspositionTable::Entry{5, 2, TranspositionTable::bound::exact, false,
+        Game::Placement{}});
+    REQUIRE(table.probe(12345, entry));
+    CHECK(entry.depth == 7);
+
+    table.clear();
+    CHECK_FALSE(table.probe(12345, entry));
+}
+
+// Tests that searches find turns that can be placed, with one thread or many.
+TEST_CASE("Alpha Beta Turns", "[search, alpha_beta]") {
+    for (int threads : {1, 4}) {
+        AlphaBetaSearch::Limits limits;
+        limits.threads = threads;
+        limits.time = std::chrono::milliseconds(0);
+        limits.nodes = 20000;
+        limits.table_megabytes = 1;
+
+        AlphaBetaSearch search(limits);
+
+        Game game(6, 2, nullptr);
+        RandomPlayer player(threads);
+        Game::Placement placement;
+
+        // Search from a few positions part way through a random game
+        for (int turn = 0; turn < 6 && !game.is_finished(); ++turn) {
+            const int id = game.get_current_actor();
+            AlphaBetaSearch::Turn found = search.search(game.get_board(), 2, id,
+                game.get_half_squares_placed());
+
+            REQUIRE(found.count > 0);
+            CHECK(found.depth > 0);
+            CHECK(found.nodes > 0);
+
+            for (int i = 0; i < found.count; ++i) {
+                REQUIRE(game.get_current_actor() == id);
+                REQUIRE(game.place(found.placements[i]));
+            }
+
+            if (player.choose_placement(game, placement)) {
+                REQUIRE(game.place(placement));
+            }
+        }
+    }
+}
+
+// Tests that a node budget with one thread always finds the same turn.
+TEST_CASE("Alpha Beta Repeatable", "[search, alpha_beta]") {
+    AlphaBetaSearch::Limits limits;
+    limits.time = std::chrono::milliseconds(0);
+    limits.nodes = 5000;
+    limits.table_megabytes = 1;
+
+    Board board(6);
+
+    AlphaBetaSearch first(limits);
+    AlphaBetaSearch second(limits);
+    AlphaBetaSearch::Turn first_turn = first.search(board, 2, 0, 0);
+    AlphaBetaSearch::Turn second_turn = second.search(board, 2, 0, 0);
+
+    REQUIRE(first_turn.count == second_turn.count);
+    CHECK(first_turn.score == second_turn.score);
+
+    for (int i = 0; i < first_turn.count; ++i) {
+        CHECK(first_turn.placements[i].x == second_turn.placements[i].x);
+        CHECK(first_turn.placements[i].y == second_turn.placements[i].y);
+        CHECK(first_turn.placements[i].shape == second_turn.placements[i].shape);
+    }
+}
+
+// Tests that Monte Carlo searches find turns that can be placed, with one
+// thread or many, and with a tree that runs out of nodes.
+TEST_CASE("Monte Carlo Turns", "[search, monte_carlo]") {
+    for (int threads : {1, 4}) {
+        for (int max_nodes : {1 << 16, 8}) {
+            MonteCarloSearch::Limits limits;
+            limits.threads = threads;
+            limits.time = std::chrono::milliseconds(0);
+            limits.playouts = 300;
+            limits.max_nodes = max_nodes;
+
+            MonteCarloSearch search(limits);
+
+            Game game(6, 2, nullptr);
+            RandomPlayer player(threads);
+            Game::Placement placement;
+
+            for (int turn = 0; turn < 4 && !game.is_finished(); ++turn) {
+                const int id = game.get_current_actor();
+                MonteCarloSearch::Turn found = search.search(game.get_board(), 2, id,
+                    game.get_half_squares_placed());
+
+                REQUIRE(found.count > 0);
+                CHECK(found.playouts >= 300);
+                CHECK(found.win_rate >= 0.0);
+                CHECK(found.win_rate <= 1.0);
+
+                for (int i = 0; i < found.count; ++i) {
+                    REQUIRE(game.get_current_actor() == id);
+                    REQUIRE(game.place(found.placements[i]));
+                }
+
+                if (player.choose_placement(game, placement)) {
+                    REQUIRE(game.place(placement));
+                }
+            }
+        }
+    }
+}
+
+// Tests that a playout budget with one thread always finds the same turn.
+TEST_CASE("Monte Carlo Repeatable", "[search, monte_carlo]") {
+    MonteCarloSearch::Limits limits;
+    limits.time = std::chrono::milliseconds(0);
+    limits.playouts = 500;
+    limits.seed = 3;
+
+    Board board(5);
+
+    MonteCarloSearch first(limits);
+    MonteCarloSearch second(limits);
+    MonteCarloSearch::Turn first_turn = first.search(board, 2, 1, 0);
+    MonteCarloSearch::Turn second_turn = second.search(board, 2, 1, 0);
+
+    REQUIRE(first_turn.count == second_turn.count);
+    CHECK(first_turn.win_rate == second_turn.win_rate);
+
+    for (int i = 0; i < first_turn.count; ++i) {
+        CHECK(first_turn.placements[i].x == second_turn.placements[i].x);
+        CHECK(first_turn.placements[i].y == second_turn.placements[i].y);
+        CHECK(first_turn.placements[i].shape == second_turn.placements[i].shape);
+    }
+}
+
+// Tests that computer players take turns through `progress_turn` without any input.
+TEST_CASE("Computer Players", "[search, actors]") {
+    Game game(4, 2, nullptr);
+
+    AlphaBetaSearch::Limits limits;
+    limits.time = std::chrono::milliseconds(0);
+    limits.nodes = 2000;
+    limits.table_megabytes = 1;
+
+    game.set_actor(0, std::make_unique<AlphaBetaPlayer>(limits));
+    MonteCarloSearch::Limits mcts_limits;
+    mcts_limits.time = std::chrono::milliseconds(0);
+    mcts_limits.playouts = 200;
+    mcts_limits.max_nodes = 1 << 12;
+
+    game.set_actor(1, std::make_unique<MonteCarloPlayer>(mcts_limits));
+
+    // Play until each actor has had a turn
+    int turns = 0;
+    int last_actor = game.get_current_actor();
+
+    while (turns < 2) {
+        game.progress_turn();
+
+        if (game.get_current_actor() != last_actor) {
+            last_actor = game.get_current_actor();
+            ++turns;
+        }
+    }
+
+    CHECK(game.get_board().get_score(0) > 1.0f);
+    CHECK(game.get_board().get_score(1) > 1.0f);
+}
+
+// Finds the most half squares an actor can place by trying every order of
+// every placement, remembering the boards that have been tried.
+static int fill_by_brute_force(const Board& board, int id,
+    std::unordered_map<std::uint64_t, int>& tried) {
+    const auto found = tried.find(board.get_key());
+
+    if (found != tried.end()) {
+        return found->second;
+    }
+
+    std::vector<Game::Placement> placements;
+    const int count = Game::generate_placements(id, 0, board, placements);
+    int most = 0;
+
+    for (int i = 0; i < count; ++i) {
+        Board next = board;
+        REQUIRE(next.place_piece(id, placements[i].shape, placements[i].x, placements[i].y));
+
+        const int placed = placements[i].shape == square_shape ? 2 : 1;
+        most = std::max(most, placed + fill_by_brute_force(next, id, tried));
+    }
+
+    tried[board.get_key()] = most;
+    return most;
+}
+
+// Tests that maximum fills place as much as trying everything, and as much as
+// the greedy fill, and that nothing more can be placed afterwards.
+TEST_CASE("Maximum Fill", "[search, fill]") {
+    FillSolver solver(1);
+
+    for (int blocks : {3, 4, 6, 8}) {
+        for (std::uint64_t seed = 0; seed < 6; ++seed) {
+            Game game(blocks, 2, nullptr);
+            RandomPlayer player(seed);
+            Game::Placement placement;
+
+            while (!game.is_finished() && player.choose_placement(game, placement)) {
+                REQUIRE(game.place(placement));
+
+                for (int id = 0; id < 2; ++id) {
+                    const Board& board = game.get_board();
+                    const int bound = solver.get_upper_bound(board, id);
+
+                    Board solved = board;
+                    const int placed = solver.solve(solved, id);
+                    CHECK(placed == bound);
+                    CHECK(solved.get_score(id) == board.get_score(id) + placed * 0.5f);
+                    CHECK(Game::count_placements(id, 0, solved) == 0);
+
+                    Board filled = board;
+                    game.simulate_filling_placements(filled, id);
+                    CHECK(filled.get_score(id) == solved.get_score(id));
+
+                    // Trying everything is only quick with a few slots left
+                    if (bound <= 6) {
+                        std::unordered_map<std::uint64_t, int> tried;
+                        CHECK(fill_by_brute_force(board, id, tried) == placed);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Tests that games end with the same scores whichever way the board is filled.
+TEST_CASE("Maximum Fill Scoring", "[search, fill]") {
+    for (std::uint64_t seed = 0; seed < 4; ++seed) {
+        Game greedy(8, 2, nullptr);
+        Game maximum(8, 2, nullptr);
+        maximum.set_scoring_mode(Game::scoring_mode::maximum_fill);
+
+        RandomPlayer player(seed);
+        Game::Placement placement;
+
+        while (!greedy.is_finished() && player.choose_placement(greedy, placement)) {
+            REQUIRE(greedy.place(placement));
+            REQUIRE(maximum.place(placement));
+            REQUIRE(maximum.is_finished() == greedy.is_finished());
+        }
+
+        REQUIRE(maximum.is_finished());
+        CHECK(maximum.get_final_scores() == greedy.get_final_scores());
+    }
+}
+
+// Tests that reachable regions are the slots that filling the board fills, and
+// that a game is finished once no two regions share a slot.
+TEST_CASE("Reachable Regions", "[search, fill]") {
+    // Only the first two players get an initial square, so any more could never
+    // place and games with them stop at their first turn
+    const int players = Board::initial_square_players;
+
+    for (std::uint64_t seed = 0; seed < 8; ++seed) {
+        Game game(6, players, nullptr);
+        RandomPlayer player(seed);
+        Game::Placement placement;
+        std::vector<ReachableRegion> regions(players);
+
+        while (player.choose_placement(game, placement)) {
+            REQUIRE(game.place(placement));
+
+            const Board& board = game.get_board();
+            bool is_shared = false;
+
+            for (int id = 0; id < players; ++id) {
+                Board filled = board;
+                game.simulate_filling_placements(filled, id);
+
+                const int free_halves = regions[id].compute(board, id);
+                CHECK(free_halves == (filled.get_score(id) - board.get_score(id)) * 2);
+
+                for (int y = 0; y < 6; ++y) {
+                    for (int x = 0; x < 6; ++x) {
+                        const Board::slot_contents before = board.get_slot(x, y);
+                        const Board::slot_contents after = filled.get_slot(x, y);
+                        const bool is_filled = before.first != after.first
+                            || before.second != after.second;
+
+                        CHECK(regions[id].contains(x, y) == is_filled);
+                    }
+                }
+
+                for (int other = 0; other < id; ++other) {
+                    is_shared = is_shared || regions[id].intersects(regions[other]);
+                }
+            }
+
+            REQUIRE(game.is_finished() == !is_shared);
+
+            if (game.is_finished()) {
+                break;
+            }
+        }
+
+        CHECK(game.is_finished());
+    }
+}
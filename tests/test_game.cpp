@@ -0,0 +1,341 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+#include "game.hpp"
+#include "actors/actor.hpp"
+#include "actors/random_player.hpp"
+#include "components/board.hpp"
+#include "components/shapes.hpp"
+#include "input/input_handler.hpp"
+#include "util/allocation_counter.hpp"
+
+// An actor that keeps rotating and switching the cursor's piece.
+class CursorActor : public Actor {
+
+    public:
+        Action do_action(const Game&) override {
+            const Action action = actions_[next_];
+            next_ = (next_ + 1) % actions_.size();
+            return action;
+        }
+
+    private:
+        std::array<Action, 6> actions_{Action::ROTATE_CLOCKWISE, Action::TOGGLE,
+            Action::ROTATE_COUNTERCLOCKWISE, Action::TOGGLE, Action::TOGGLE, Action::NONE};
+        int next_ = 0;
+};
+
+// Tests that turns move on once a square or two halves have been placed.
+TEST_CASE("Placement Turns", "[game, place]") {
+    Game game(8, 2, nullptr);
+
+    REQUIRE(game.get_current_actor() == 0);
+
+    // Placements have to touch the player's own pieces.
+    REQUIRE_FALSE(game.place(Game::Placement{3, 3, square_shape}));
+
+    REQUIRE(game.place(Game::Placement{1, 6, triangle_shape}));
+    CHECK(game.get_current_actor() == 0);
+    CHECK(game.get_half_squares_placed() == 1);
+
+    // A square doesn't fit in what is left of the turn.
+    REQUIRE_FALSE(game.place(Game::Placement{0, 6, square_shape}));
+
+    REQUIRE(game.place(Game::Placement{0, 6, rectangle_shape}));
+    CHECK(game.get_current_actor() == 1);
+    CHECK(game.get_half_squares_placed() == 0);
+
+    REQUIRE(game.place(Game::Placement{6, 1, square_shape}));
+    CHECK(game.get_current_actor() == 0);
+    CHECK(game.get_board().get_score(1) == 2.0f);
+}
+
+// Tests that random games always end and that simulating the players in
+// parallel finds the same end of the game.
+TEST_CASE("Random Games", "[game, finished]") {
+    for (int seed = 0; seed < 5; ++seed) {
+        Game serial(8, 2, nullptr);
+        Game parallel(8, 2, nullptr);
+        parallel.set_simulation_threads(2);
+
+        RandomPlayer player(seed);
+        Game::Placement placement;
+
+        while (!serial.is_finished()) {
+            REQUIRE(player.choose_placement(serial, placement));
+            REQUIRE(serial.place(placement));
+            REQUIRE(parallel.place(placement));
+            REQUIRE(parallel.is_finished() == serial.is_finished());
+        }
+
+        CHECK(parallel.get_final_scores() == serial.get_final_scores());
+        CHECK(serial.get_final_scores()[0] + serial.get_final_scores()[1] == 64.0f);
+    }
+}
+
+// Tests that the generated placements are exactly the placements that are
+// valid when checked one at a time.
+TEST_CASE("Placement Generation", "[game, placements]") {
+    for (int seed = 0; seed < 3; ++seed) {
+        Game game(5, 2, nullptr);
+        RandomPlayer player(seed);
+        Game::Placement placement;
+
+        std::vector<Game::Placement> placements(Game::get_max_placements(5));
+
+        while (!game.is_finished() && player.choose_placement(game, placement)) {
+            const Board& board = game.get_board();
+
+            for (int owner = 0; owner < 2; ++owner) {
+                for (int half_squares_placed = 0; half_squares_placed < 2; ++half_squares_placed) {
+                    const int count = game.generate_placements(owner, half_squares_placed,
+                        board, placements);
+
+                    int expected = 0;
+
+                    for (int y = 0; y < 5; ++y) {
+                        for (int x = 0; x < 5; ++x) {
+                            for (shape_id shape = 0; shape < shape_count; ++shape) {
+                                if (!game.check_if_valid_placement(owner, shape, x, y,
+                                    half_squares_placed, board)) {
+                                    continue;
+                                }
+
+                                REQUIRE(expected < count);
+                                CHECK(placements[expected].x == x);
+                                CHECK(placements[expected].y == y);
+                                CHECK(placements[expected].shape == shape);
+                                ++expected;
+                            }
+                        }
+                    }
+
+                    REQUIRE(count == expected);
+                    CHECK(game.count_placements(owner, half_squares_placed, board) == count);
+
+                    // Generating stops once the buffer is full
+                    CHECK(game.generate_placements(owner, half_squares_placed, board,
+                        std::span(placements.data(), count / 2)) == count / 2);
+                }
+            }
+
+            REQUIRE(game.place(placement));
+        }
+    }
+}
+
+// Tests that simulating an actor's placements fills every slot they can reach
+// on the board that is given, even when it isn't the board of the game.
+TEST_CASE("Filling Simulation", "[game, finished]") {
+    for (int seed = 0; seed < 4; ++seed) {
+        Game game(8, 2, nullptr);
+        Game other(8, 2, nullptr);
+        RandomPlayer player(seed);
+        RandomPlayer other_player(seed + 100);
+        Game::Placement placement;
+
+        for (int turn = 0; turn < 40; ++turn) {
+            if (player.choose_placement(game, placement)) {
+                REQUIRE(game.place(placement));
+            }
+
+            if (other_player.choose_placement(other, placement)) {
+                REQUIRE(other.place(placement));
+            }
+
+            for (const Board* board : {&game.get_board(), &other.get_board()}) {
+                for (int id = 0; id < 2; ++id) {
+                    Board filled = *board;
+                    game.simulate_filling_placements(filled, id);
+
+                    // Nothing is left for the actor to place, and only their pieces
+                    // were added
+                    CHECK(Game::count_placements(id, 0, filled) == 0);
+                    CHECK(filled.get_score(1 - id) == board->get_score(1 - id));
+                    CHECK(filled.get_score(id) >= board->get_score(id));
+                }
+            }
+        }
+    }
+}
+
+// Tests that the keys kept up to date as pieces are placed are the same as
+// the keys computed from scratch, and that the key of the game tells turns apart.
+TEST_CASE("Position Keys", "[game, keys]") {
+    for (int seed = 0; seed < 5; ++seed) {
+        Game game(7, 2, nullptr);
+        RandomPlayer player(seed);
+        Game::Placement placement;
+
+        REQUIRE(game.get_board().get_key() == game.get_board().compute_key());
+        REQUIRE(game.get_board().get_key() == Board(7).get_key());
+
+        while (!game.is_finished() && player.choose_placement(game, placement)) {
+            const std::uint64_t key_before = game.get_key();
+            const int actor_before = game.get_current_actor();
+
+            REQUIRE(game.place(placement));
+
+            const Board& board = game.get_board();
+            REQUIRE(board.get_key() == board.compute_key());
+            CHECK(game.get_key() != key_before);
+            CHECK(game.get_key() == (board.get_key()
+                ^ Game::get_turn_key(game.get_current_actor(), game.get_half_squares_placed())));
+
+            // The same pieces on the same board with a different turn has a different key
+            if (game.get_current_actor() != actor_before) {
+                CHECK(game.get_key() != (board.get_key() ^ Game::get_turn_key(actor_before, 0)));
+            }
+        }
+
+        // Clearing the board goes back to the key of a new board
+        Board board = game.get_board();
+        board.clear();
+        CHECK(board.get_key() == Board(7).get_key());
+        CHECK(board.get_key() == board.compute_key());
+    }
+
+    // The order pieces are placed in doesn't change the key
+    Board first(4);
+    Board second(4);
+    REQUIRE(first.place_piece(0, triangle_shape, 1, 3));
+    REQUIRE(first.place_piece(0, triangle_shape + 2, 1, 3));
+    REQUIRE(second.place_piece(0, triangle_shape + 2, 1, 3));
+    REQUIRE(second.place_piece(0, triangle_shape, 1, 3));
+    CHECK(first.get_key() == second.get_key());
+}
+
+// Everything about a game's position that a move can change.
+static std::vector<std::uint64_t> get_position(Game& game) {
+    const Board& board = game.get_board();
+    const int size = board.get_size();
+
+    std::vector<std::uint64_t> position{board.get_key(), board.compute_key(),
+        static_cast<std::uint64_t>(game.get_current_actor()),
+        static_cast<std::uint64_t>(game.get_half_squares_placed()),
+        static_cast<std::uint64_t>(game.is_finished())};
+
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            const Board::slot_contents slot = board.get_slot(x, y);
+            position.push_back((slot.first.owner + 1) * 16 + slot.first.shape);
+            position.push_back((slot.second.owner + 1) * 16 + slot.second.shape);
+
+            for (int owner = 0; owner < game.get_num_actors(); ++owner) {
+                position.push_back(board.get_touching_points(owner, x, y));
+            }
+        }
+    }
+
+    return position;
+}
+
+// Tests that random sequences of moves and undos always go back to the same
+// positions they came from.
+TEST_CASE("Make and Unmake Moves", "[game, moves]") {
+    // Only the first two players get an initial square, so any more could never
+    // place and the moves would stop at their first turn
+    const int players = Board::initial_square_players;
+
+    for (std::uint64_t seed = 0; seed < 8; ++seed) {
+        Game game(6, players, nullptr);
+        std::mt19937_64 generator(seed);
+        std::vector<Game::Placement> placements;
+
+        // The position before each move that can be undone
+        std::vector<std::vector<std::uint64_t>> positions;
+        std::size_t deepest = 0;
+
+        for (int step = 0; step < 400; ++step) {
+            const int count = Game::generate_placements(game.get_current_actor(),
+                game.get_half_squares_placed(), game.get_board(), placements);
+
+            // Make more moves than are undone, so the moves go deep
+            if (count > 0 && (positions.empty() || generator() % 3 != 0)) {
+                positions.push_back(get_position(game));
+                REQUIRE(game.make_move(placements[generator() % count]));
+                REQUIRE(game.get_move_count() == static_cast<int>(positions.size()));
+                deepest = std::max(deepest, positions.size());
+            } else if (!positions.empty()) {
+                game.unmake_move();
+                REQUIRE(get_position(game) == positions.back());
+                positions.pop_back();
+            } else {
+                break;
+            }
+        }
+
+        CHECK(deepest >= 40);
+
+        while (!positions.empty()) {
+            game.unmake_move();
+            REQUIRE(get_position(game) == positions.back());
+            positions.pop_back();
+        }
+
+        Game fresh(6, players, nullptr);
+        CHECK(game.get_move_count() == 0);
+        CHECK(get_position(game) == get_position(fresh));
+    }
+
+    // Moves can't be undone once a placement is made for real
+    Game game(6, 2, nullptr);
+    std::vector<Game::Placement> placements;
+    Game::generate_placements(0, 0, game.get_board(), placements);
+
+    CHECK_FALSE(game.make_move(Game::Placement{3, 3, square_shape}));
+    REQUIRE(game.make_move(placements[0]));
+    CHECK(game.get_move_count() == 1);
+
+    Game::generate_placements(game.get_current_actor(), game.get_half_squares_placed(),
+        game.get_board(), placements);
+    REQUIRE(game.place(placements[0]));
+    CHECK(game.get_move_count() == 0);
+}
+
+// Tests that the cursor and the pieces of the board are shared instead of being
+// made again whenever they change.
+TEST_CASE("Piece Allocations", "[game, pieces]") {
+    InputHandler input_handler;
+    Game game(8, 2, &input_handler);
+    game.set_actor(0, std::make_unique<CursorActor>());
+
+    // Go through every piece once so they all exist
+    for (int i = 0; i < 64; ++i) {
+        game.progress_turn();
+    }
+
+    const long long allocations_before = get_allocation_count();
+
+    shape_id last_shape = game.get_cursor().piece->get_shape();
+    int shape_changes = 0;
+
+    for (int i = 0; i < 600; ++i) {
+        game.progress_turn();
+
+        const shape_id shape = game.get_cursor().piece->get_shape();
+        shape_changes += shape != last_shape;
+        last_shape = shape;
+    }
+
+    const Board::board_pointer pieces = game.get_board().get_board();
+    int pieces_seen = 0;
+
+    for (int y = 0; y < 8; ++y) {
+        for (int x = 0; x < 8; ++x) {
+            const Board::board_slot slot = pieces[y][x];
+            pieces_seen += (slot.first != nullptr) + (slot.second != nullptr);
+        }
+    }
+
+    const long long allocations_made = get_allocation_count() - allocations_before;
+
+    CHECK(shape_changes > 0);
+    CHECK(pieces_seen == 2);
+    CHECK(allocations_made == 0);
+}